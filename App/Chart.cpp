@@ -0,0 +1,414 @@
+#include "Chart.hpp"
+
+#include "Thermodynamics.hpp"
+#include "StandardChart.hpp"
+
+#include <MesumGraphics/DearImgui/imgui_internal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+using namespace m;
+using namespace thermodynamics;
+
+ImVec2 get_posFromTempAndPhi(mFloat const a_temperature, mFloat const a_phi,
+                             ImVec2 const &a_boundsTemp,
+                             ImVec2 const &a_boundsPhi,
+                             ImVec2 const &a_sizeGraph,
+                             mFloat const  a_angleGraph)
+{
+    ImVec2 result{0.0f, 0.0f};
+    mFloat tempRatio =
+        (a_temperature - a_boundsTemp.x) / (a_boundsTemp.y - a_boundsTemp.x);
+    mFloat tephiRatio =
+        (a_phi - a_boundsPhi.x) / (a_boundsPhi.y - a_boundsPhi.x);
+
+    ImVec2 oT{tempRatio * a_sizeGraph.x, (-0.5f * a_sizeGraph.y)};
+    ImVec2 oPhi{0.5f * a_sizeGraph.x, -tephiRatio * a_sizeGraph.y};
+
+    mFloat alphaT   = std::sin(a_angleGraph);
+    mFloat alphaPhi = std::cos(a_angleGraph);
+    mFloat betaT    = -std::cos(a_angleGraph);
+    mFloat betaPhi  = std::sin(a_angleGraph);
+
+    mFloat tPhi = 0;
+    if (alphaT == 0)
+    {
+        result.x = oT.x;
+        result.y = oPhi.y;
+    }
+    else
+    {
+        tPhi = (oT.y + (betaT / alphaT) * (oPhi.x - oT.x) - oPhi.y) /
+               (betaPhi - betaT * (alphaPhi / alphaT));
+
+        result.x = oPhi.x + alphaPhi * tPhi;
+        result.y = oPhi.y + betaPhi * tPhi;
+    }
+
+    return result;
+}
+
+mFloat get_yFromXandPressure(mFloat const a_x, mFloat const a_pressure,
+                             ImVec2 const &a_boundsTemperature,
+                             ImVec2 const &a_boundsPhi,
+                             ImVec2 const &a_sizeGraph, mFloat a_angleGraph)
+{
+    mFloat b      = 0.5 * a_sizeGraph.y;
+    mFloat b2     = 0.5 * a_sizeGraph.x;
+    mFloat sx     = a_sizeGraph.x;
+    mFloat sy     = a_sizeGraph.y;
+    mFloat mt     = a_boundsTemperature.x + g_c2k;
+    mFloat mphi   = a_boundsPhi.x;
+    mFloat dt     = a_boundsTemperature.y - a_boundsTemperature.x;
+    mFloat dphi   = a_boundsPhi.y - a_boundsPhi.x;
+    mFloat tan    = std::tan(a_angleGraph);
+    mFloat invTan = 1 / tan;
+    mFloat p      = std::pow(100 / a_pressure, g_k);
+    mFloat temperature =
+        (mphi +
+         (b + (a_x - b2) * tan + invTan * (mt * sx / dt + a_x)) * (dphi / sy)) /
+        (p + (dphi / sy) * invTan * sx / dt);
+    return -invTan * ((temperature - mt) * sx / dt - a_x) + b;
+}
+
+template <typename t_Lines>
+void load_bakedLines(std::vector<std::vector<ImVec2>> &a_lines,
+                     t_Lines const                    &a_bakedLines)
+{
+    a_lines.resize(a_bakedLines.size());
+    for (mUInt k = 0; k < a_bakedLines.size(); ++k)
+    {
+        a_lines[k].resize(a_bakedLines[k].size());
+        for (mUInt i = 0; i < a_bakedLines[k].size(); ++i)
+        {
+            a_lines[k][i] = {a_bakedLines[k][i].temperature,
+                             a_bakedLines[k][i].phi};
+        }
+    }
+}
+
+void compute_pressureLines(std::vector<std::vector<ImVec2>> &a_lines,
+                           GridParameters const             &a_gp,
+                           PressureLineParameters const     &a_plp,
+                           mInt const                        a_tempMargin)
+{
+    mFloat deltaTemp =
+        (a_gp.boundTemp.y - a_gp.boundTemp.x) / (a_gp.divTemp + 1);
+
+    a_lines.resize(a_plp.nbPressureLine);
+    for (mUInt k = 0; k < a_plp.nbPressureLine; ++k)
+    {
+        mFloat pressure = a_plp.maxPressure - k * a_plp.deltaPressure;
+        a_lines[k].resize(a_gp.divTemp + 2 * a_tempMargin + 2);
+        for (mUInt i = 0; i < a_lines[k].size(); ++i)
+        {
+            mFloat temperature =
+                a_gp.boundTemp.x + deltaTemp * (mInt(i) - a_tempMargin);
+            a_lines[k][i] = {temperature, get_phi(temperature, pressure)};
+        }
+    }
+}
+
+void compute_vaporLines(std::vector<std::vector<ImVec2>> &a_lines,
+                        GridParameters const             &a_gp,
+                        VaporLineParameters const        &a_vlp,
+                        mInt const                        a_tempMargin)
+{
+    mFloat deltaTemp =
+        (a_gp.boundTemp.y - a_gp.boundTemp.x) / (a_gp.divTemp + 1);
+
+    a_lines.resize(a_vlp.wss.size());
+    for (mUInt k = 0; k < a_vlp.wss.size(); ++k)
+    {
+        mFloat ws = a_vlp.wss[k];
+        a_lines[k].resize(a_gp.divTemp + 2 * a_tempMargin + 2);
+        for (mUInt i = 0; i < a_lines[k].size(); ++i)
+        {
+            mFloat temperature =
+                a_gp.boundTemp.x + deltaTemp * (mInt(i) - a_tempMargin);
+            temperature = std::max(temperature, standardChart::g_minVaporTemp);
+            mFloat pressure = get_pressureFromWandTemperature(ws, temperature);
+            a_lines[k][i]   = {temperature, get_phi(temperature, pressure)};
+        }
+    }
+}
+
+void compute_pseudoAdiabats(std::vector<std::vector<ImVec2>> &a_lines,
+                            PseudoAdiabatsParameters const   &a_pap)
+{
+    const mInt   subDivisions  = standardChart::g_pseudoAdiabatSubdivisions;
+    const mFloat pressureStart = standardChart::g_pseudoAdiabatStartPressure;
+    const mFloat pressureGoal  = standardChart::g_pseudoAdiabatGoalPressure;
+    mFloat       deltaP        = (pressureGoal - pressureStart) / subDivisions;
+
+    a_lines.resize(a_pap.nbLine);
+    for (mUInt k = 0; k < a_pap.nbLine; ++k)
+    {
+        a_lines[k].resize(subDivisions);
+        mFloat temperature = a_pap.minTemp + a_pap.deltaTemp * k;
+        mFloat pressure    = pressureStart;
+        for (mInt d = 0; d < subDivisions; ++d)
+        {
+            a_lines[k][d] = {temperature, get_phi(temperature, pressure)};
+
+            // Update temperature and pressure
+            temperature += get_pseudoAdiabatDeltaT(temperature, pressure,
+                                                   deltaP);
+            pressure += deltaP;
+        }
+    }
+}
+
+// Uses the compile time tables for the standard chart, runtime physics
+// otherwise
+void build_isopleths(ChartIsopleths &a_isopleths, GridParameters const &a_gp,
+                     PressureLineParameters const   &a_plp,
+                     VaporLineParameters const      &a_vlp,
+                     PseudoAdiabatsParameters const &a_pap,
+                     mInt const                      a_tempMargin)
+{
+    a_isopleths.tempMargin =
+        std::max(a_tempMargin, standardChart::g_tempMargin);
+    mBool isStandardTemperatureAxis =
+        a_gp.has_standardTemperatureAxis() &&
+        a_isopleths.tempMargin == standardChart::g_tempMargin;
+
+    if (isStandardTemperatureAxis && a_plp.is_standard())
+    {
+        load_bakedLines(a_isopleths.pressureLines,
+                        standardChart::g_pressureLines);
+    }
+    else
+    {
+        compute_pressureLines(a_isopleths.pressureLines, a_gp, a_plp,
+                              a_isopleths.tempMargin);
+    }
+
+    if (isStandardTemperatureAxis && a_vlp.is_standard())
+    {
+        load_bakedLines(a_isopleths.vaporLines, standardChart::g_vaporLines);
+    }
+    else
+    {
+        compute_vaporLines(a_isopleths.vaporLines, a_gp, a_vlp,
+                           a_isopleths.tempMargin);
+    }
+
+    if (a_pap.is_standard())
+    {
+        load_bakedLines(a_isopleths.pseudoAdiabats,
+                        standardChart::g_pseudoAdiabats);
+    }
+    else
+    {
+        compute_pseudoAdiabats(a_isopleths.pseudoAdiabats, a_pap);
+    }
+}
+
+void project_lines(std::vector<std::vector<ImVec2>>       &a_outLines,
+                   std::vector<std::vector<ImVec2>> const &a_dataLines,
+                   mInt const a_firstSample, mInt const a_nbSamples,
+                   ImVec2 const &a_sizeGraph, mFloat const a_angleGraph,
+                   GridParameters const &a_gp)
+{
+    a_outLines.resize(a_dataLines.size());
+    for (mUInt k = 0; k < a_dataLines.size(); ++k)
+    {
+        a_outLines[k].resize(a_nbSamples);
+        for (mInt i = 0; i < a_nbSamples; ++i)
+        {
+            ImVec2 const &point = a_dataLines[k][a_firstSample + i];
+            a_outLines[k][i] = get_posFromTempAndPhi(
+                point.x, point.y, a_gp.boundTemp, a_gp.boundPhi, a_sizeGraph,
+                a_angleGraph);
+        }
+    }
+}
+
+ImVec4 get_chartColor(ChartElement const a_element)
+{
+    switch (a_element)
+    {
+        case ChartElement::canvas: return {0.95f, 0.95f, 0.85f, 1.0f};
+        case ChartElement::background: return {0.9f, 0.9f, 0.8f, 1.0f};
+        case ChartElement::grid: return {0.0f, 0.1f, 0.2f, 0.7f};
+        case ChartElement::pressure: return {0.0f, 0.1f, 0.2f, 0.2f};
+        case ChartElement::vapor: return {0.0f, 0.6f, 0.2f, 0.2f};
+        case ChartElement::pseudoAdiabat: return {0.1f, 0.0f, 0.2f, 0.2f};
+        case ChartElement::sounding: return {0.8f, 0.1f, 0.1f, 1.0f};
+    }
+    return {0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+void build_chartGeometry(ChartGeometry &a_geometry, ChartIsopleths &a_isopleths,
+                         mBool &a_isoplethsDirty, GridParameters const &a_gp,
+                         PressureLineParameters const   &a_plp,
+                         VaporLineParameters const      &a_vlp,
+                         PseudoAdiabatsParameters const &a_pap,
+                         ImVec2 const                   &a_sizeGraph)
+{
+    a_geometry.sizeGraph = a_sizeGraph;
+    a_geometry.lines.clear();
+    a_geometry.labels.clear();
+
+    mFloat minTemp   = a_gp.boundTemp[0];
+    mFloat maxTemp   = a_gp.boundTemp[1];
+    mFloat deltaTemp = (maxTemp - minTemp) / (a_gp.divTemp + 1);
+    mFloat minPhi    = a_gp.boundPhi[0];
+    mFloat maxPhi    = a_gp.boundPhi[1];
+    mFloat deltaPhi  = (maxPhi - minPhi) / (a_gp.divPhi + 1);
+    mFloat angle     = std::numbers::pi * a_gp.rotation;
+
+    mFloat tiltX             = std::tan(angle) * (0.5 * a_sizeGraph.y);
+    mFloat sizeHorizontal    = a_sizeGraph.x / (a_gp.divTemp + 1);
+    mInt   additionalDivTemp = tiltX / sizeHorizontal;
+
+    mFloat tiltY            = std::tan(angle) * (0.5 * a_sizeGraph.x);
+    mFloat sizeVertical     = a_sizeGraph.y / (a_gp.divPhi + 1);
+    mInt   additionalDivPhi = tiltY / sizeVertical;
+
+    if (a_isoplethsDirty || additionalDivTemp > a_isopleths.tempMargin)
+    {
+        build_isopleths(a_isopleths, a_gp, a_plp, a_vlp, a_pap,
+                        additionalDivTemp);
+        a_isoplethsDirty = false;
+    }
+    // Temperature samples visible with the current tilt
+    mInt firstSample = a_isopleths.tempMargin - additionalDivTemp;
+    mInt nbSamples   = a_gp.divTemp + 2 * additionalDivTemp + 2;
+
+    // Crooked
+    for (mInt i = -additionalDivTemp; i <= (a_gp.divTemp + additionalDivTemp);
+         ++i)
+    {
+        mFloat xPos = i * sizeHorizontal;
+
+        a_geometry.lines.push_back(
+            {ChartElement::grid,
+             {ImVec2(xPos - tiltX, 0), ImVec2(xPos + tiltX, -a_sizeGraph.y)}});
+
+        mFloat temperature = minTemp + deltaTemp * i;
+
+        char string[16];
+        ImFormatString(string, 16, "%.0f", temperature);
+        a_geometry.labels.push_back(
+            {ImVec2(xPos, -(0.5 * a_sizeGraph.y)), string});
+    }
+
+    for (mInt i = -additionalDivPhi; i <= (a_gp.divPhi + additionalDivPhi);
+         ++i)
+    {
+        mFloat yPos = -sizeVertical * i;
+
+        a_geometry.lines.push_back(
+            {ChartElement::grid,
+             {ImVec2(0, yPos - tiltY), ImVec2(a_sizeGraph.x, yPos + tiltY)}});
+
+        mFloat phi = minPhi + deltaPhi * i;
+
+        char string[16];
+        ImFormatString(string, 16, "%.0f", phi);
+        a_geometry.labels.push_back(
+            {ImVec2((0.5 * a_sizeGraph.x) + 5, yPos - 5), string});
+    }
+
+    std::vector<std::vector<ImVec2>> lines;
+
+    // Pressure Lines
+    if (a_plp.showPressureLine)
+    {
+        for (mUInt k = 0; k < a_plp.nbPressureLine; ++k)
+        {
+            mFloat pressure = a_plp.maxPressure - k * a_plp.deltaPressure;
+            mFloat x        = (a_gp.divTemp / 4) * sizeHorizontal;
+            mFloat y =
+                get_yFromXandPressure(x, pressure, {minTemp, maxTemp},
+                                      {minPhi, maxPhi}, a_sizeGraph, angle);
+
+            char string[16];
+            ImFormatString(string, 16, "p:%d", mInt(pressure));
+            a_geometry.labels.push_back({ImVec2(x, -y), string});
+        }
+
+        project_lines(lines, a_isopleths.pressureLines, firstSample, nbSamples,
+                      a_sizeGraph, angle, a_gp);
+        for (auto &line : lines)
+        {
+            a_geometry.lines.push_back(
+                {ChartElement::pressure, std::move(line)});
+        }
+    }
+
+    // Vapor Lines
+    if (a_vlp.showVaporLines)
+    {
+        project_lines(lines, a_isopleths.vaporLines, firstSample, nbSamples,
+                      a_sizeGraph, angle, a_gp);
+        for (auto &line : lines)
+        {
+            a_geometry.lines.push_back({ChartElement::vapor, std::move(line)});
+        }
+    }
+
+    // Pseudo Adiabats
+    if (a_pap.showPseudoAdiabats)
+    {
+        project_lines(lines, a_isopleths.pseudoAdiabats, 0,
+                      standardChart::g_pseudoAdiabatSubdivisions, a_sizeGraph,
+                      angle, a_gp);
+        for (auto &line : lines)
+        {
+            a_geometry.lines.push_back(
+                {ChartElement::pseudoAdiabat, std::move(line)});
+        }
+    }
+}
+
+mDouble get_chartGeometryNbPoints(GridParameters const           &a_gp,
+                                  PressureLineParameters const   &a_plp,
+                                  VaporLineParameters const      &a_vlp,
+                                  PseudoAdiabatsParameters const &a_pap,
+                                  ImVec2 const                   &a_sizeGraph)
+{
+    // Same divisions as build_chartGeometry, in double to not overflow
+    mDouble tan = std::tan(std::numbers::pi * a_gp.rotation);
+    mDouble additionalDivTemp =
+        std::floor(tan * 0.5 * a_sizeGraph.y * (a_gp.divTemp + 1) /
+                   a_sizeGraph.x);
+    mDouble additionalDivPhi = std::floor(
+        tan * 0.5 * a_sizeGraph.x * (a_gp.divPhi + 1) / a_sizeGraph.y);
+
+    mDouble nbGridPoints = 2.0 * (a_gp.divTemp + 2 * additionalDivTemp + 1) +
+                           2.0 * (a_gp.divPhi + 2 * additionalDivPhi + 1);
+    mDouble nbTempSamples =
+        a_gp.divTemp +
+        2 * std::max<mDouble>(additionalDivTemp, standardChart::g_tempMargin) +
+        2;
+
+    return nbGridPoints +
+           nbTempSamples * (a_plp.nbPressureLine + a_vlp.wss.size()) +
+           mDouble(a_pap.nbLine) * standardChart::g_pseudoAdiabatSubdivisions;
+}
+
+void add_soundingLine(ChartGeometry                    &a_geometry,
+                      std::vector<SoundingLevel> const &a_levels,
+                      GridParameters const             &a_gp)
+{
+    mFloat    angle = std::numbers::pi * a_gp.rotation;
+    ChartLine line{ChartElement::sounding, {}};
+    line.points.reserve(a_levels.size());
+    for (SoundingLevel const &level : a_levels)
+    {
+        if (level.pressure <= 0.0f)
+        {
+            continue;
+        }
+
+        line.points.push_back(get_posFromTempAndPhi(
+            level.temperature, get_phi(level.temperature, level.pressure),
+            a_gp.boundTemp, a_gp.boundPhi, a_geometry.sizeGraph, angle));
+    }
+    a_geometry.lines.push_back(std::move(line));
+}
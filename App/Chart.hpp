@@ -0,0 +1,108 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+#include <MesumGraphics/DearImgui/MesumDearImGui.hpp>
+
+#include "ChartParameters.hpp"
+#include "Sounding.hpp"
+
+#include <string>
+#include <vector>
+
+inline ImVec2 operator+(ImVec2 const &a_r, ImVec2 const &a_l)
+{
+    return {a_r.x + a_l.x, a_r.y + a_l.y};
+}
+
+inline ImVec2 operator-(ImVec2 const &a_r, ImVec2 const &a_l)
+{
+    return {a_r.x - a_l.x, a_r.y - a_l.y};
+}
+
+ImVec2 get_posFromTempAndPhi(m::mFloat const a_temperature,
+                             m::mFloat const a_phi,
+                             ImVec2 const   &a_boundsTemp,
+                             ImVec2 const   &a_boundsPhi,
+                             ImVec2 const   &a_sizeGraph,
+                             m::mFloat const a_angleGraph);
+
+m::mFloat get_yFromXandPressure(m::mFloat const a_x, m::mFloat const a_pressure,
+                                ImVec2 const &a_boundsTemperature,
+                                ImVec2 const &a_boundsPhi,
+                                ImVec2 const &a_sizeGraph,
+                                m::mFloat     a_angleGraph);
+
+// Isopleths in data space, x: temperature °C, y: phi °K
+// Pressure and vapor lines are sampled on the grid temperature divisions,
+// extended by tempMargin divisions on both sides to cover the tilted grid.
+struct ChartIsopleths
+{
+    m::mInt                          tempMargin{0};
+    std::vector<std::vector<ImVec2>> pressureLines;
+    std::vector<std::vector<ImVec2>> vaporLines;
+    std::vector<std::vector<ImVec2>> pseudoAdiabats;
+};
+
+// Uses the compile time tables for the standard chart, runtime physics
+// otherwise
+void build_isopleths(ChartIsopleths &a_isopleths, GridParameters const &a_gp,
+                     PressureLineParameters const   &a_plp,
+                     VaporLineParameters const      &a_vlp,
+                     PseudoAdiabatsParameters const &a_pap,
+                     m::mInt const                   a_tempMargin);
+
+enum class ChartElement
+{
+    canvas,
+    background,
+    grid,
+    pressure,
+    vapor,
+    pseudoAdiabat,
+    sounding
+};
+
+ImVec4 get_chartColor(ChartElement const a_element);
+
+struct ChartLine
+{
+    ChartElement        element;
+    std::vector<ImVec2> points;
+};
+
+struct ChartLabel
+{
+    ImVec2      position;
+    std::string text;
+};
+
+// Chart in screen space, positions are relative to the bottom left corner of
+// the graph, y pointing down. Labels use the grid color.
+struct ChartGeometry
+{
+    ImVec2                  sizeGraph{0.0f, 0.0f};
+    std::vector<ChartLine>  lines;
+    std::vector<ChartLabel> labels;
+};
+
+// a_isopleths is rebuilt when a_isoplethsDirty is set or when the tilt of the
+// grid needs more temperature samples
+void build_chartGeometry(ChartGeometry &a_geometry, ChartIsopleths &a_isopleths,
+                         m::mBool &a_isoplethsDirty, GridParameters const &a_gp,
+                         PressureLineParameters const   &a_plp,
+                         VaporLineParameters const      &a_vlp,
+                         PseudoAdiabatsParameters const &a_pap,
+                         ImVec2 const                   &a_sizeGraph);
+
+// Number of points build_chartGeometry produces, computed without building
+// the geometry. Tilted grids with many divisions on a narrow graph need a lot
+// of temperature samples.
+m::mDouble get_chartGeometryNbPoints(GridParameters const           &a_gp,
+                                     PressureLineParameters const   &a_plp,
+                                     VaporLineParameters const      &a_vlp,
+                                     PseudoAdiabatsParameters const &a_pap,
+                                     ImVec2 const &a_sizeGraph);
+
+void add_soundingLine(ChartGeometry                    &a_geometry,
+                      std::vector<SoundingLevel> const &a_levels,
+                      GridParameters const             &a_gp);
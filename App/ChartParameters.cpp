@@ -0,0 +1,273 @@
+#include "ChartParameters.hpp"
+
+#include <MesumGraphics/DearImgui/imgui_internal.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace m;
+
+namespace
+{
+// Limits of the parameters read from text, well past what the panels allow
+const mInt   g_maxDivisions    = 100;
+const mInt   g_maxLines        = 100;
+const mFloat g_maxReadRotation = 0.49f;    // rad
+const mFloat g_maxReadTemp     = 150.0f;   // °C
+const mFloat g_maxReadPhi      = 1000.0f;  // °K
+const mFloat g_maxReadPressure = 1000.0f;  // kPa
+
+// Finite, ordered and within [-a_max, a_max]
+mBool is_readBound(ImVec2 const &a_bound, mFloat const a_max)
+{
+    return a_bound.x >= -a_max && a_bound.x < a_bound.y && a_bound.y <= a_max;
+}
+}  // namespace
+
+mBool GridParameters::expose_dearImGui()
+{
+    mBool changed = false;
+    if (ImGui::TreeNode("Grid Parameters"))
+    {
+        changed |= ImGui::DragFloat2("Temperature Bounds (°C)", &boundTemp.x,
+                                     0.5, -50, 50);
+        changed |=
+            ImGui::DragInt("Temperature Subdivisions", &divTemp, 1, 0, 20);
+        ImGui::DragFloat2("Temperature Capacity Bounds (°K)", &boundPhi.x, 0.5,
+                          50, 700);
+        ImGui::DragInt("Temperature Capacity Subdivisions", &divPhi, 1, 0, 20);
+        // The pressure labels are undefined without rotation
+        ImGui::DragFloat("grid angle(rad)", &rotation, 0.01,
+                         standardChart::g_minRotation,
+                         standardChart::g_maxRotation);
+        ImGui::TreePop();
+    }
+    return changed;
+}
+
+mBool GridParameters::has_standardTemperatureAxis() const
+{
+    return boundTemp.x == standardChart::g_minTemp &&
+           boundTemp.y == standardChart::g_maxTemp &&
+           divTemp == standardChart::g_divTemp;
+}
+
+mBool GridParameters::operator==(GridParameters const &a_other) const
+{
+    return boundTemp.x == a_other.boundTemp.x &&
+           boundTemp.y == a_other.boundTemp.y && divTemp == a_other.divTemp &&
+           boundPhi.x == a_other.boundPhi.x &&
+           boundPhi.y == a_other.boundPhi.y && divPhi == a_other.divPhi &&
+           rotation == a_other.rotation;
+}
+
+mBool PressureLineParameters::expose_dearImGui()
+{
+    mBool changed = false;
+    if (ImGui::TreeNode("Pressure Lines"))
+    {
+        ImGui::Checkbox("Show Pressure Lines", &showPressureLine);
+
+        changed |=
+            ImGui::DragInt("Nb Pressure Lines", &nbPressureLine, 1, 1, 10);
+        changed |=
+            ImGui::DragFloat("Max Pressure (kPa)", &maxPressure, 1, 10, 100);
+        changed |=
+            ImGui::DragFloat("Pressure Delta", &deltaPressure, 1, 1, 30);
+        // Keeps the lowest pressure line above 0 kPa
+        deltaPressure = std::min(deltaPressure, maxPressure / nbPressureLine);
+
+        ImGui::TreePop();
+    }
+    return changed;
+}
+
+mBool PressureLineParameters::is_standard() const
+{
+    return nbPressureLine == standardChart::g_nbPressureLines &&
+           maxPressure == standardChart::g_maxPressure &&
+           deltaPressure == standardChart::g_deltaPressure;
+}
+
+mBool PressureLineParameters::operator==(
+    PressureLineParameters const &a_other) const
+{
+    return nbPressureLine == a_other.nbPressureLine &&
+           maxPressure == a_other.maxPressure &&
+           deltaPressure == a_other.deltaPressure &&
+           showPressureLine == a_other.showPressureLine;
+}
+
+mBool VaporLineParameters::expose_dearImGui()
+{
+    mBool changed = false;
+    if (ImGui::TreeNode("Vapor Lines"))
+    {
+        ImGui::Checkbox("Show vapor lines", &showVaporLines);
+
+        changed |= ImGui::DragInt("Nb Vapor lines", &nbVaporLines, 1, 1, 10);
+        if (wss.size() != nbVaporLines)
+        {
+            wss.resize(nbVaporLines);
+        }
+
+        for (mUInt i = 0; i < wss.size(); ++i)
+        {
+            char name[16];
+            ImFormatString(name, 16, "ws %d", mInt(i));
+            changed |= ImGui::DragFloat(name, &wss[i], 0.01f, 0.1f, 100.0f);
+        }
+
+        ImGui::TreePop();
+    }
+    return changed;
+}
+
+mBool VaporLineParameters::is_standard() const
+{
+    return std::equal(wss.begin(), wss.end(), standardChart::g_wss.begin(),
+                      standardChart::g_wss.end());
+}
+
+mBool VaporLineParameters::operator==(VaporLineParameters const &a_other) const
+{
+    return nbVaporLines == a_other.nbVaporLines && wss == a_other.wss &&
+           showVaporLines == a_other.showVaporLines;
+}
+
+mBool PseudoAdiabatsParameters::expose_dearImGui()
+{
+    mBool changed = false;
+    if (ImGui::TreeNode("Pseudo Adiabats"))
+    {
+        ImGui::Checkbox("Show pseudo adiabats", &showPseudoAdiabats);
+
+        changed |= ImGui::DragInt("Nb pseudo adiabats", &nbLine, 1, 1, 10);
+        changed |=
+            ImGui::DragFloat("Min temperature (°C)", &minTemp, 1, -40, 40);
+        changed |= ImGui::DragFloat("temperature Delta (°C)", &deltaTemp, 1,
+                                    0.5, 10);
+
+        ImGui::TreePop();
+    }
+    return changed;
+}
+
+mBool PseudoAdiabatsParameters::is_standard() const
+{
+    return nbLine == standardChart::g_nbPseudoAdiabats &&
+           minTemp == standardChart::g_minPseudoAdiabatTemp &&
+           deltaTemp == standardChart::g_deltaPseudoAdiabatTemp;
+}
+
+mBool PseudoAdiabatsParameters::operator==(
+    PseudoAdiabatsParameters const &a_other) const
+{
+    return nbLine == a_other.nbLine && minTemp == a_other.minTemp &&
+           deltaTemp == a_other.deltaTemp &&
+           showPseudoAdiabats == a_other.showPseudoAdiabats;
+}
+
+void ClimatologyParameters::expose_dearImGui()
+{
+    loadRequested  = false;
+    clearRequested = false;
+    if (ImGui::TreeNode("Climatology"))
+    {
+        ImGui::Checkbox("Show density", &showDensity);
+        ImGui::DragFloat("Opacity", &opacity, 0.01f, 0.0f, 1.0f);
+
+        ImGui::InputText("Soundings file", path, sizeof(path));
+        loadRequested = ImGui::Button("Add soundings");
+        ImGui::SameLine();
+        clearRequested = ImGui::Button("Clear");
+
+        ImGui::TreePop();
+    }
+}
+
+void write_chartParameters(std::ostream                   &a_stream,
+                           GridParameters const           &a_gp,
+                           PressureLineParameters const   &a_plp,
+                           VaporLineParameters const      &a_vlp,
+                           PseudoAdiabatsParameters const &a_pap)
+{
+    a_stream << a_gp.boundTemp.x << ' ' << a_gp.boundTemp.y << ' '
+             << a_gp.divTemp << ' ' << a_gp.boundPhi.x << ' '
+             << a_gp.boundPhi.y << ' ' << a_gp.divPhi << ' ' << a_gp.rotation;
+
+    a_stream << ' ' << a_plp.nbPressureLine << ' ' << a_plp.maxPressure << ' '
+             << a_plp.deltaPressure << ' ' << a_plp.showPressureLine;
+
+    a_stream << ' ' << a_vlp.nbVaporLines << ' ' << a_vlp.showVaporLines << ' '
+             << a_vlp.wss.size();
+    for (mFloat ws : a_vlp.wss) { a_stream << ' ' << ws; }
+
+    a_stream << ' ' << a_pap.nbLine << ' ' << a_pap.minTemp << ' '
+             << a_pap.deltaTemp << ' ' << a_pap.showPseudoAdiabats;
+}
+
+mBool read_chartParameters(std::istream &a_stream, GridParameters &a_gp,
+                           PressureLineParameters   &a_plp,
+                           VaporLineParameters      &a_vlp,
+                           PseudoAdiabatsParameters &a_pap)
+{
+    // Comparisons are written so that NaN fails them
+    a_stream >> a_gp.boundTemp.x >> a_gp.boundTemp.y >> a_gp.divTemp >>
+        a_gp.boundPhi.x >> a_gp.boundPhi.y >> a_gp.divPhi >> a_gp.rotation;
+    if (!is_readBound(a_gp.boundTemp, g_maxReadTemp) ||
+        !is_readBound(a_gp.boundPhi, g_maxReadPhi) || a_gp.divTemp < 0 ||
+        a_gp.divTemp > g_maxDivisions || a_gp.divPhi < 0 ||
+        a_gp.divPhi > g_maxDivisions ||
+        !(a_gp.rotation > 0.0f && a_gp.rotation <= g_maxReadRotation))
+    {
+        return false;
+    }
+
+    a_stream >> a_plp.nbPressureLine >> a_plp.maxPressure >>
+        a_plp.deltaPressure >> a_plp.showPressureLine;
+    if (a_plp.nbPressureLine < 0 || a_plp.nbPressureLine > g_maxLines ||
+        !(a_plp.maxPressure <= g_maxReadPressure) ||
+        !(a_plp.deltaPressure >= 0.0f &&
+          a_plp.deltaPressure <= g_maxReadPressure))
+    {
+        return false;
+    }
+    // Lowest pressure line, the others are above
+    if (a_plp.nbPressureLine > 0 &&
+        !(a_plp.maxPressure -
+              (a_plp.nbPressureLine - 1) * a_plp.deltaPressure >
+          0.0f))
+    {
+        return false;
+    }
+
+    mUInt nbWss = 0;
+    a_stream >> a_vlp.nbVaporLines >> a_vlp.showVaporLines >> nbWss;
+    if (nbWss > g_maxLines || a_vlp.nbVaporLines != mInt(nbWss))
+    {
+        return false;
+    }
+    a_vlp.wss.resize(nbWss);
+    for (mFloat &ws : a_vlp.wss)
+    {
+        // The saturation pressure formula needs 0 < ws < 1000 * eps g/kg
+        a_stream >> ws;
+        if (!(ws > 0.0f && ws < 1000 * thermodynamics::g_eps))
+        {
+            return false;
+        }
+    }
+
+    a_stream >> a_pap.nbLine >> a_pap.minTemp >> a_pap.deltaTemp >>
+        a_pap.showPseudoAdiabats;
+    if (a_pap.nbLine < 0 || a_pap.nbLine > g_maxLines ||
+        !(std::abs(a_pap.minTemp) <= g_maxReadTemp) ||
+        !(std::abs(a_pap.minTemp + a_pap.nbLine * a_pap.deltaTemp) <=
+          g_maxReadTemp))
+    {
+        return false;
+    }
+
+    return !a_stream.fail();
+}
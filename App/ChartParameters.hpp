@@ -0,0 +1,93 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+#include <MesumGraphics/DearImgui/MesumDearImGui.hpp>
+
+#include "StandardChart.hpp"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+struct GridParameters
+{
+    ImVec2  boundTemp{standardChart::g_minTemp,
+                      standardChart::g_maxTemp};  // °C
+    m::mInt divTemp{standardChart::g_divTemp};
+    ImVec2  boundPhi{standardChart::g_minPhi, standardChart::g_maxPhi};  // °K
+    m::mInt divPhi{standardChart::g_divPhi};
+
+    m::mFloat rotation{standardChart::g_rotation};  // rad
+
+    // Returns true when the temperature axis changed, the other parameters
+    // only affect the projection of the isopleths
+    m::mBool expose_dearImGui();
+    m::mBool has_standardTemperatureAxis() const;
+
+    m::mBool operator==(GridParameters const &a_other) const;
+};
+
+struct PressureLineParameters
+{
+    m::mInt   nbPressureLine{standardChart::g_nbPressureLines};
+    m::mFloat maxPressure{standardChart::g_maxPressure};  // kPa
+    m::mFloat deltaPressure{standardChart::g_deltaPressure};
+
+    m::mBool showPressureLine{true};
+
+    m::mBool expose_dearImGui();
+    m::mBool is_standard() const;
+
+    m::mBool operator==(PressureLineParameters const &a_other) const;
+};
+
+struct VaporLineParameters
+{
+    m::mInt                nbVaporLines{standardChart::g_nbVaporLines};
+    std::vector<m::mFloat> wss = std::vector<m::mFloat>(
+        standardChart::g_wss.begin(), standardChart::g_wss.end());
+    m::mBool               showVaporLines{true};
+
+    m::mBool expose_dearImGui();
+    m::mBool is_standard() const;
+
+    m::mBool operator==(VaporLineParameters const &a_other) const;
+};
+
+struct PseudoAdiabatsParameters
+{
+    m::mInt   nbLine{standardChart::g_nbPseudoAdiabats};
+    m::mFloat minTemp{standardChart::g_minPseudoAdiabatTemp};  // kPa
+    m::mFloat deltaTemp{standardChart::g_deltaPseudoAdiabatTemp};
+
+    m::mBool showPseudoAdiabats{true};
+
+    m::mBool expose_dearImGui();
+    m::mBool is_standard() const;
+
+    m::mBool operator==(PseudoAdiabatsParameters const &a_other) const;
+};
+
+struct ClimatologyParameters
+{
+    m::mBool  showDensity{true};
+    m::mFloat opacity{0.8f};
+    char      path[256]{};
+
+    m::mBool loadRequested{false};
+    m::mBool clearRequested{false};
+
+    void expose_dearImGui();
+};
+
+// Space separated text, used by the input recordings and the render server
+void     write_chartParameters(std::ostream                   &a_stream,
+                               GridParameters const           &a_gp,
+                               PressureLineParameters const   &a_plp,
+                               VaporLineParameters const      &a_vlp,
+                               PseudoAdiabatsParameters const &a_pap);
+// Fails on malformed input or values out of the ranges the chart can handle
+m::mBool read_chartParameters(std::istream &a_stream, GridParameters &a_gp,
+                              PressureLineParameters   &a_plp,
+                              VaporLineParameters      &a_vlp,
+                              PseudoAdiabatsParameters &a_pap);
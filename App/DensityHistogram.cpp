@@ -0,0 +1,222 @@
+#include "DensityHistogram.hpp"
+
+#include "Chart.hpp"
+#include "Thermodynamics.hpp"
+
+#include <MesumGraphics/DearImgui/imgui_internal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+using namespace m;
+
+namespace
+{
+// Levels per thread under which spawning threads is not worth it
+const std::size_t g_minLevelsPerThread = 65536;
+
+void bin_levels(SoundingLevel const *a_begin, SoundingLevel const *a_end,
+                DensityHistogram::Bins &a_bins)
+{
+    using namespace thermodynamics;
+
+    for (SoundingLevel const *level = a_begin; level != a_end; ++level)
+    {
+        if (level->pressure <= 0.0f)
+        {
+            continue;
+        }
+
+        mFloat phi     = get_phi(level->temperature, level->pressure);
+        mFloat tempBin = (level->temperature - DensityHistogram::s_minTemp) /
+                         DensityHistogram::s_binTemp;
+        mFloat phiBin =
+            (phi - DensityHistogram::s_minPhi) / DensityHistogram::s_binPhi;
+        // Range checked before the conversion to integer, also rejects nan
+        if (!(tempBin >= 0.0f && tempBin < DensityHistogram::s_nbBinsTemp &&
+              phiBin >= 0.0f && phiBin < DensityHistogram::s_nbBinsPhi))
+        {
+            continue;
+        }
+
+        mInt tempIndex = mInt(tempBin);
+        mInt phiIndex  = mInt(phiBin);
+        ++a_bins[phiIndex * DensityHistogram::s_nbBinsTemp + tempIndex];
+    }
+}
+}  // namespace
+
+void DensityHistogram::add_toBins(std::vector<SoundingLevel> const &a_levels,
+                                  Bins                             &a_bins)
+{
+    std::size_t nbThreads =
+        std::clamp<std::size_t>(a_levels.size() / g_minLevelsPerThread, 1,
+                                std::max(std::thread::hardware_concurrency(),
+                                         1u));
+
+    // The calling thread fills a_bins directly
+    std::vector<Bins> threadBins(nbThreads - 1,
+                                 Bins(s_nbBinsTemp * s_nbBinsPhi, 0));
+    std::vector<std::thread> threads;
+    threads.reserve(nbThreads - 1);
+
+    std::size_t chunkSize = (a_levels.size() + nbThreads - 1) / nbThreads;
+    for (std::size_t t = 0; t < nbThreads; ++t)
+    {
+        std::size_t first = std::min(t * chunkSize, a_levels.size());
+        std::size_t last  = std::min(first + chunkSize, a_levels.size());
+
+        SoundingLevel const *begin = a_levels.data() + first;
+        SoundingLevel const *end   = a_levels.data() + last;
+        if (t + 1 == nbThreads)
+        {
+            bin_levels(begin, end, a_bins);
+        }
+        else
+        {
+            threads.emplace_back(bin_levels, begin, end,
+                                 std::ref(threadBins[t]));
+        }
+    }
+    for (std::thread &thread : threads) { thread.join(); }
+
+    for (Bins const &bins : threadBins)
+    {
+        for (std::size_t i = 0; i < a_bins.size(); ++i)
+        {
+            a_bins[i] += bins[i];
+        }
+    }
+}
+
+DensityHistogram::Bins DensityHistogram::load_bins(std::string const &a_path)
+{
+    Bins bins(s_nbBinsTemp * s_nbBinsPhi, 0);
+    if (!load_soundingLevels(a_path,
+                             [&bins](std::vector<SoundingLevel> const &a_levels)
+                             { add_toBins(a_levels, bins); }))
+    {
+        return Bins{};
+    }
+    return bins;
+}
+
+void DensityHistogram::merge(Bins const &a_bins)
+{
+    for (std::size_t i = 0; i < m_bins.size(); ++i)
+    {
+        m_bins[i] += a_bins[i];
+        m_maxCount = std::max(m_maxCount, m_bins[i]);
+        m_nbLevels += a_bins[i];
+    }
+    ++m_version;
+}
+
+void DensityHistogram::clear()
+{
+    std::fill(m_bins.begin(), m_bins.end(), 0);
+    m_maxCount = 0;
+    m_nbLevels = 0;
+    ++m_version;
+}
+
+void update_densityHeatmap(DensityHeatmap         &a_heatmap,
+                           DensityHistogram const &a_histogram,
+                           ImVec2 const &a_sizeGraph, mFloat const a_angleGraph,
+                           GridParameters const &a_gp, mFloat const a_opacity)
+{
+    if (a_heatmap.isValid &&
+        a_heatmap.histogramVersion == a_histogram.get_version() &&
+        a_heatmap.gp == a_gp && a_heatmap.sizeGraph.x == a_sizeGraph.x &&
+        a_heatmap.sizeGraph.y == a_sizeGraph.y &&
+        a_heatmap.opacity == a_opacity)
+    {
+        return;
+    }
+
+    a_heatmap.isValid          = true;
+    a_heatmap.histogramVersion = a_histogram.get_version();
+    a_heatmap.gp               = a_gp;
+    a_heatmap.sizeGraph        = a_sizeGraph;
+    a_heatmap.opacity          = a_opacity;
+    a_heatmap.corners.clear();
+    a_heatmap.colors.clear();
+
+    if (a_histogram.get_maxCount() == 0)
+    {
+        return;
+    }
+
+    // The projection is affine in (temperature, phi), bins corners are
+    // interpolated from the projection of one bin
+    ImVec2 origin = get_posFromTempAndPhi(
+        DensityHistogram::s_minTemp, DensityHistogram::s_minPhi, a_gp.boundTemp,
+        a_gp.boundPhi, a_sizeGraph, a_angleGraph);
+    ImVec2 stepTemp =
+        get_posFromTempAndPhi(
+            DensityHistogram::s_minTemp + DensityHistogram::s_binTemp,
+            DensityHistogram::s_minPhi, a_gp.boundTemp, a_gp.boundPhi,
+            a_sizeGraph, a_angleGraph) -
+        origin;
+    ImVec2 stepPhi =
+        get_posFromTempAndPhi(
+            DensityHistogram::s_minTemp,
+            DensityHistogram::s_minPhi + DensityHistogram::s_binPhi,
+            a_gp.boundTemp, a_gp.boundPhi, a_sizeGraph, a_angleGraph) -
+        origin;
+
+    // Log scale, a few soundings at the edges of the climatology stay visible
+    mFloat invLogMax = 1.0f / std::log(1.0f + a_histogram.get_maxCount());
+    for (mInt j = 0; j < DensityHistogram::s_nbBinsPhi; ++j)
+    {
+        for (mInt i = 0; i < DensityHistogram::s_nbBinsTemp; ++i)
+        {
+            mUInt count = a_histogram.get_count(i, j);
+            if (count == 0)
+            {
+                continue;
+            }
+
+            mFloat density = std::log(1.0f + count) * invLogMax;
+            a_heatmap.colors.push_back(
+                ImColor(0.8f, 0.3f - 0.2f * density, 0.1f,
+                        a_opacity * (0.1f + 0.9f * density)));
+
+            ImVec2 corner = origin + ImVec2(i * stepTemp.x + j * stepPhi.x,
+                                            i * stepTemp.y + j * stepPhi.y);
+            a_heatmap.corners.push_back(corner);
+            a_heatmap.corners.push_back(corner + stepTemp);
+            a_heatmap.corners.push_back(corner + stepTemp + stepPhi);
+            a_heatmap.corners.push_back(corner + stepPhi);
+        }
+    }
+}
+
+void draw_densityHeatmap(ImDrawList           *a_drawList,
+                         DensityHeatmap const &a_heatmap,
+                         ImVec2 const         &a_graphOrigin)
+{
+    // Reserved in chunks, the draw list splits its commands before 16 bits
+    // indices overflow on each reservation
+    static const mUInt s_nbQuadsPerChunk = 1024;
+
+    ImVec2 const &uv      = ImGui::GetDrawListSharedData()->TexUvWhitePixel;
+    ImVec2 const *corners = a_heatmap.corners.data();
+    for (mUInt first = 0; first < a_heatmap.colors.size();
+         first += s_nbQuadsPerChunk)
+    {
+        mUInt last = std::min<mUInt>(first + s_nbQuadsPerChunk,
+                                     a_heatmap.colors.size());
+        a_drawList->PrimReserve(6 * (last - first), 4 * (last - first));
+        for (mUInt q = first; q < last; ++q)
+        {
+            ImVec2 const *quad = corners + 4 * q;
+            a_drawList->PrimQuadUV(
+                a_graphOrigin + quad[0], a_graphOrigin + quad[1],
+                a_graphOrigin + quad[2], a_graphOrigin + quad[3], uv, uv, uv,
+                uv, a_heatmap.colors[q]);
+        }
+    }
+}
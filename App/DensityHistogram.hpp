@@ -0,0 +1,83 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+#include <MesumGraphics/DearImgui/MesumDearImGui.hpp>
+
+#include "ChartParameters.hpp"
+#include "Sounding.hpp"
+
+#include <string>
+#include <vector>
+
+// 2D histogram of sounding levels in data space (temperature °C, phi °K)
+// Binning does not depend on the chart bounds or rotation, new soundings can
+// be added at any time.
+class DensityHistogram
+{
+   public:
+    static constexpr m::mInt   s_nbBinsTemp = 256;
+    static constexpr m::mInt   s_nbBinsPhi  = 256;
+    static constexpr m::mFloat s_minTemp    = -100.0f;  // °C
+    static constexpr m::mFloat s_maxTemp    = 50.0f;    // °C
+    static constexpr m::mFloat s_minPhi     = 200.0f;   // °K
+    static constexpr m::mFloat s_maxPhi     = 500.0f;   // °K
+    static constexpr m::mFloat s_binTemp =
+        (s_maxTemp - s_minTemp) / s_nbBinsTemp;
+    static constexpr m::mFloat s_binPhi = (s_maxPhi - s_minPhi) / s_nbBinsPhi;
+
+    using Bins = std::vector<m::mUInt>;  // s_nbBinsPhi rows of s_nbBinsTemp
+
+    // Bins the levels on all hardware threads and adds them to a_bins, each
+    // thread fills its own bins from a contiguous range of levels, the bins
+    // are summed at the end.
+    static void add_toBins(std::vector<SoundingLevel> const &a_levels,
+                           Bins                             &a_bins);
+    // Bins a soundings file chunk by chunk as it is parsed, memory does not
+    // grow with the file size. Empty on failure.
+    // Thread safe, can run in the background before merge.
+    static Bins load_bins(std::string const &a_path);
+
+    void merge(Bins const &a_bins);
+    void clear();
+
+    m::mUInt get_count(m::mInt const a_tempIndex,
+                       m::mInt const a_phiIndex) const
+    {
+        return m_bins[a_phiIndex * s_nbBinsTemp + a_tempIndex];
+    }
+    m::mUInt    get_maxCount() const { return m_maxCount; }
+    std::size_t get_nbLevels() const { return m_nbLevels; }
+    // Incremented on every change of the bins
+    m::mUInt get_version() const { return m_version; }
+
+   private:
+    Bins        m_bins = Bins(s_nbBinsTemp * s_nbBinsPhi, 0);
+    m::mUInt    m_maxCount{0};
+    std::size_t m_nbLevels{0};
+    m::mUInt    m_version{0};
+};
+
+// Colored bins of the climatology projected on the graph, relative to the
+// graph origin. Only rebuilt when the histogram, the opacity or the
+// projection change, drawing copies the quads to the draw list.
+struct DensityHeatmap
+{
+    std::vector<ImVec2> corners;  // 4 per colored bin
+    std::vector<ImU32>  colors;
+
+    m::mUInt       histogramVersion{0};
+    m::mBool       isValid{false};
+    GridParameters gp;
+    ImVec2         sizeGraph{0.0f, 0.0f};
+    m::mFloat      opacity{0.0f};
+};
+
+void update_densityHeatmap(DensityHeatmap         &a_heatmap,
+                           DensityHistogram const &a_histogram,
+                           ImVec2 const           &a_sizeGraph,
+                           m::mFloat const         a_angleGraph,
+                           GridParameters const   &a_gp,
+                           m::mFloat const         a_opacity);
+void draw_densityHeatmap(ImDrawList           *a_drawList,
+                         DensityHeatmap const &a_heatmap,
+                         ImVec2 const         &a_graphOrigin);
@@ -0,0 +1,418 @@
+#include "InputRecording.hpp"
+
+#include <MesumGraphics/DearImgui/imgui_internal.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace m;
+
+namespace
+{
+const char *g_recordingHeader  = "tephigram-recording";
+const mInt  g_recordingVersion = 4;
+
+// Delta time of the layout frame, past the double click delay so that clicks
+// of the previous scenario do not pair with the first ones of the next
+const mFloat g_settleDeltaTime = 1.0f;  // s
+
+mBool is_sameClimatology(ClimatologyParameters const &a_cp,
+                         ClimatologyParameters const &a_other)
+{
+    return a_cp.showDensity == a_other.showDensity &&
+           a_cp.opacity == a_other.opacity &&
+           std::strcmp(a_cp.path, a_other.path) == 0;
+}
+
+mDouble get_percentile(std::vector<mDouble> const &a_sortedValues,
+                       mDouble const               a_percentile)
+{
+    // Nearest rank
+    mUInt rank = mUInt(std::ceil(a_percentile * a_sortedValues.size()));
+    return a_sortedValues[std::max(rank, 1u) - 1];
+}
+}  // namespace
+
+mBool InputRecording::save(std::string const &a_path) const
+{
+    std::ofstream file(a_path);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << std::setprecision(9);
+    file << g_recordingHeader << ' ' << g_recordingVersion << '\n';
+    file << "display " << displaySize.x << ' ' << displaySize.y << '\n';
+    for (RecordedFrame const &frame : frames)
+    {
+        file << "frame " << frame.mousePos.x << ' ' << frame.mousePos.y << ' '
+             << frame.mouseButtons << ' ' << frame.mouseWheel.x << ' '
+             << frame.mouseWheel.y << ' ' << frame.deltaTime << '\n';
+        if (frame.hasParameters)
+        {
+            file << "params ";
+            write_chartParameters(file, frame.gp, frame.plp, frame.vlp,
+                                  frame.pap);
+            file << '\n';
+        }
+        if (frame.hasClimatology)
+        {
+            // Path last, up to the end of the line
+            file << "climatology " << frame.cp.showDensity << ' '
+                 << frame.cp.opacity << ' ' << frame.cp.loadRequested << ' '
+                 << frame.cp.clearRequested << ' ' << frame.cp.path << '\n';
+        }
+    }
+    return file.good();
+}
+
+mBool InputRecording::load(std::string const &a_path)
+{
+    std::ifstream file(a_path);
+    std::string   header;
+    mInt          version = 0;
+    if (!(file >> header >> version) || header != g_recordingHeader ||
+        version != g_recordingVersion)
+    {
+        return false;
+    }
+
+    name = std::filesystem::path(a_path).stem().string();
+    frames.clear();
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string        tag;
+        if (!(stream >> tag))
+        {
+            continue;
+        }
+
+        if (tag == "display")
+        {
+            stream >> displaySize.x >> displaySize.y;
+        }
+        else if (tag == "frame")
+        {
+            RecordedFrame &frame = frames.emplace_back();
+            if (!(stream >> frame.mousePos.x >> frame.mousePos.y >>
+                  frame.mouseButtons >> frame.mouseWheel.x >>
+                  frame.mouseWheel.y >> frame.deltaTime) ||
+                !(frame.deltaTime > 0.0f))
+            {
+                return false;
+            }
+        }
+        else if (tag == "params" && !frames.empty())
+        {
+            RecordedFrame &frame = frames.back();
+            frame.hasParameters  = true;
+            if (!read_chartParameters(stream, frame.gp, frame.plp, frame.vlp,
+                                      frame.pap))
+            {
+                return false;
+            }
+        }
+        else if (tag == "climatology" && !frames.empty())
+        {
+            RecordedFrame &frame = frames.back();
+            frame.hasClimatology = true;
+            std::string path;
+            if (!(stream >> frame.cp.showDensity >> frame.cp.opacity >>
+                  frame.cp.loadRequested >> frame.cp.clearRequested) ||
+                !(frame.cp.opacity >= 0.0f && frame.cp.opacity <= 1.0f))
+            {
+                return false;
+            }
+            stream.get();
+            std::getline(stream, path);
+            if (path.size() >= sizeof(frame.cp.path))
+            {
+                return false;
+            }
+            std::copy(path.begin(), path.end(), frame.cp.path);
+            frame.cp.path[path.size()] = '\0';
+        }
+    }
+
+    return !frames.empty() && displaySize.x > 0.0f && displaySize.y > 0.0f;
+}
+
+void InputRecorder::start(std::string const &a_path)
+{
+    m_path = a_path;
+    m_recording.frames.clear();
+    // First frame always stores the parameters
+    m_lastParameters     = RecordedFrame{};
+    m_hasLastClimatology = false;
+    m_isSettingLayout    = true;
+}
+
+void InputRecorder::stop()
+{
+    if (!is_recording())
+    {
+        return;
+    }
+
+    if (!m_recording.save(m_path))
+    {
+        std::cerr << "Failed to save input recording to " << m_path << '\n';
+    }
+    m_path.clear();
+}
+
+void InputRecorder::record_frame(ImGuiIO const                  &a_io,
+                                 GridParameters const           &a_gp,
+                                 PressureLineParameters const   &a_plp,
+                                 VaporLineParameters const      &a_vlp,
+                                 PseudoAdiabatsParameters const &a_pap,
+                                 ClimatologyParameters const    &a_cp)
+{
+    if (!is_recording())
+    {
+        return;
+    }
+
+    if (m_isSettingLayout)
+    {
+        m_recording.displaySize = a_io.DisplaySize;
+        m_isSettingLayout       = false;
+        return;
+    }
+
+    RecordedFrame &frame = m_recording.frames.emplace_back();
+    frame.mousePos       = a_io.MousePos;
+    for (mInt i = 0; i < ImGuiMouseButton_COUNT; ++i)
+    {
+        if (a_io.MouseDown[i])
+        {
+            frame.mouseButtons |= 1u << i;
+        }
+    }
+    frame.mouseWheel = {a_io.MouseWheelH, a_io.MouseWheel};
+    frame.deltaTime  = a_io.DeltaTime;
+
+    if (!m_lastParameters.hasParameters || a_gp != m_lastParameters.gp ||
+        a_plp != m_lastParameters.plp || a_vlp != m_lastParameters.vlp ||
+        a_pap != m_lastParameters.pap)
+    {
+        frame.hasParameters = true;
+        frame.gp            = a_gp;
+        frame.plp           = a_plp;
+        frame.vlp           = a_vlp;
+        frame.pap           = a_pap;
+        m_lastParameters    = frame;
+    }
+
+    if (!m_hasLastClimatology || a_cp.loadRequested || a_cp.clearRequested ||
+        !is_sameClimatology(a_cp, m_lastClimatology))
+    {
+        frame.hasClimatology = true;
+        frame.cp             = a_cp;
+        m_lastClimatology    = a_cp;
+        m_hasLastClimatology = true;
+    }
+}
+
+mBool InputReplayer::start(std::string const &a_paths)
+{
+    m_recordings.clear();
+    m_frameTimes.clear();
+    m_scenario        = 0;
+    m_frame           = 0;
+    m_isSettingLayout = true;
+    m_hasFailed       = false;
+
+    std::istringstream paths(a_paths);
+    std::string        path;
+    while (std::getline(paths, path, ';'))
+    {
+        if (path.empty())
+        {
+            continue;
+        }
+
+        InputRecording &recording = m_recordings.emplace_back();
+        if (!recording.load(path))
+        {
+            std::cerr << "Failed to load input recording " << path << '\n';
+            m_recordings.clear();
+            return false;
+        }
+    }
+
+    return !m_recordings.empty();
+}
+
+void InputReplayer::feed_input(ImGuiIO &a_io)
+{
+    if (!is_replaying())
+    {
+        return;
+    }
+
+    // Only the recorded input reaches ImGui
+    ImGui::GetCurrentContext()->InputEventsQueue.resize(0);
+
+    InputRecording const &recording = m_recordings[m_scenario];
+    if (m_isSettingLayout)
+    {
+        // Widget positions depend on the display size
+        if (a_io.DisplaySize.x != recording.displaySize.x ||
+            a_io.DisplaySize.y != recording.displaySize.y)
+        {
+            std::cerr << "Recording " << recording.name << " was made on a "
+                      << recording.displaySize.x << 'x'
+                      << recording.displaySize.y << " display, can not replay "
+                      << "it on " << a_io.DisplaySize.x << 'x'
+                      << a_io.DisplaySize.y << '\n';
+            m_hasFailed = true;
+            m_scenario  = mUInt(m_recordings.size());
+            return;
+        }
+
+        a_io.DeltaTime = g_settleDeltaTime;
+
+        // Releases whatever the previous scenario left pressed
+        a_io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+        for (mInt i = 0; i < ImGuiMouseButton_COUNT; ++i)
+        {
+            a_io.AddMouseButtonEvent(i, false);
+        }
+        return;
+    }
+
+    // Double clicks and other timed widget behaviors follow the recorded time,
+    // not the replay speed
+    RecordedFrame const &frame = m_recordings[m_scenario].frames[m_frame];
+    a_io.DeltaTime             = frame.deltaTime;
+    a_io.AddMousePosEvent(frame.mousePos.x, frame.mousePos.y);
+    for (mInt i = 0; i < ImGuiMouseButton_COUNT; ++i)
+    {
+        a_io.AddMouseButtonEvent(i, (frame.mouseButtons & (1u << i)) != 0);
+    }
+    if (frame.mouseWheel.x != 0.0f || frame.mouseWheel.y != 0.0f)
+    {
+        a_io.AddMouseWheelEvent(frame.mouseWheel.x, frame.mouseWheel.y);
+    }
+}
+
+mBool InputReplayer::apply_parameters(GridParameters           &a_gp,
+                                      PressureLineParameters   &a_plp,
+                                      VaporLineParameters      &a_vlp,
+                                      PseudoAdiabatsParameters &a_pap) const
+{
+    if (!is_replaying() || m_isSettingLayout)
+    {
+        return false;
+    }
+
+    RecordedFrame const &frame = m_recordings[m_scenario].frames[m_frame];
+    if (!frame.hasParameters)
+    {
+        return false;
+    }
+
+    // Same rule as the panels, the grid projection and the show flags do not
+    // change the isopleths
+    PressureLineParameters   plp = frame.plp;
+    VaporLineParameters      vlp = frame.vlp;
+    PseudoAdiabatsParameters pap = frame.pap;
+    plp.showPressureLine         = a_plp.showPressureLine;
+    vlp.showVaporLines           = a_vlp.showVaporLines;
+    pap.showPseudoAdiabats       = a_pap.showPseudoAdiabats;
+    mBool const changed =
+        frame.gp.boundTemp.x != a_gp.boundTemp.x ||
+        frame.gp.boundTemp.y != a_gp.boundTemp.y ||
+        frame.gp.divTemp != a_gp.divTemp || plp != a_plp || vlp != a_vlp ||
+        pap != a_pap;
+
+    a_gp  = frame.gp;
+    a_plp = frame.plp;
+    a_vlp = frame.vlp;
+    a_pap = frame.pap;
+    return changed;
+}
+
+void InputReplayer::apply_climatology(ClimatologyParameters &a_cp) const
+{
+    if (!is_replaying() || m_isSettingLayout)
+    {
+        return;
+    }
+
+    // Presses of the replayed mouse input do not count, only the recorded ones
+    RecordedFrame const &frame = m_recordings[m_scenario].frames[m_frame];
+    if (frame.hasClimatology)
+    {
+        a_cp = frame.cp;
+    }
+    else
+    {
+        a_cp.loadRequested  = false;
+        a_cp.clearRequested = false;
+    }
+
+    // Soundings of the previous scenario
+    if (m_frame == 0)
+    {
+        a_cp.clearRequested = true;
+    }
+}
+
+void InputReplayer::end_frame(
+    std::chrono::steady_clock::duration const &a_frameTime)
+{
+    if (!is_replaying())
+    {
+        return;
+    }
+
+    if (m_isSettingLayout)
+    {
+        m_isSettingLayout = false;
+        return;
+    }
+
+    m_frameTimes.push_back(a_frameTime);
+    if (++m_frame < m_recordings[m_scenario].frames.size())
+    {
+        return;
+    }
+
+    report_scenario();
+    m_frameTimes.clear();
+    m_frame           = 0;
+    m_isSettingLayout = true;
+    ++m_scenario;
+}
+
+void InputReplayer::report_scenario() const
+{
+    std::vector<mDouble> frameTimesMs;
+    frameTimesMs.reserve(m_frameTimes.size());
+    for (auto const &frameTime : m_frameTimes)
+    {
+        frameTimesMs.push_back(
+            std::chrono::duration<mDouble, std::milli>(frameTime).count());
+    }
+    std::sort(frameTimesMs.begin(), frameTimesMs.end());
+
+    std::cout << std::fixed << std::setprecision(3) << "[frame time] "
+              << m_recordings[m_scenario].name << " frames "
+              << frameTimesMs.size() << " p50 "
+              << get_percentile(frameTimesMs, 0.50) << "ms p95 "
+              << get_percentile(frameTimesMs, 0.95) << "ms p99 "
+              << get_percentile(frameTimesMs, 0.99) << "ms" << std::endl;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+#include <MesumGraphics/DearImgui/MesumDearImGui.hpp>
+
+#include "ChartParameters.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Input of one frame, as seen by dear ImGui
+struct RecordedFrame
+{
+    ImVec2    mousePos{0.0f, 0.0f};
+    m::mUInt  mouseButtons{0};  // one bit per ImGuiMouseButton
+    ImVec2    mouseWheel{0.0f, 0.0f};
+    m::mFloat deltaTime{0.0f};  // s, io.DeltaTime
+
+    // Parameters are only stored on frames where they were edited
+    m::mBool                 hasParameters{false};
+    GridParameters           gp;
+    PressureLineParameters   plp;
+    VaporLineParameters      vlp;
+    PseudoAdiabatsParameters pap;
+
+    // Climatology panel, stored on frames where it changed or one of its
+    // buttons was pressed. Keyboard input is not recorded, the typed soundings
+    // path is replayed from here.
+    m::mBool              hasClimatology{false};
+    ClimatologyParameters cp;
+};
+
+struct InputRecording
+{
+    std::string                name;
+    ImVec2                     displaySize{0.0f, 0.0f};
+    std::vector<RecordedFrame> frames;
+
+    m::mBool save(std::string const &a_path) const;
+    m::mBool load(std::string const &a_path);
+};
+
+// Captures the ImGui input stream and the parameter edits of a session
+// The first frame after start is not recorded, the harness window layout is
+// applied during it. Sessions are expected to start without climatology.
+class InputRecorder
+{
+   public:
+    void     start(std::string const &a_path);
+    void     stop();
+    m::mBool is_recording() const { return !m_path.empty(); }
+    m::mBool is_settingLayout() const { return m_isSettingLayout; }
+
+    // To call once the parameter panels are exposed
+    void record_frame(ImGuiIO const &a_io, GridParameters const &a_gp,
+                      PressureLineParameters const   &a_plp,
+                      VaporLineParameters const      &a_vlp,
+                      PseudoAdiabatsParameters const &a_pap,
+                      ClimatologyParameters const    &a_cp);
+
+   private:
+    std::string           m_path;
+    InputRecording        m_recording;
+    RecordedFrame         m_lastParameters;
+    ClimatologyParameters m_lastClimatology;
+    m::mBool              m_hasLastClimatology{false};
+    m::mBool              m_isSettingLayout{false};
+};
+
+// Plays recordings back frame by frame and reports frame time percentiles
+// for each of them
+// Each scenario starts with an unmeasured frame, without input, during which
+// the harness window layout is applied. The platform input is dropped.
+// Scenarios start without climatology, the replayed soundings are loaded
+// synchronously on the frame their load was requested.
+class InputReplayer
+{
+   public:
+    // a_paths is a list of recording files separated by ';', one scenario per
+    // file
+    m::mBool start(std::string const &a_paths);
+    m::mBool is_replaying() const { return m_scenario < m_recordings.size(); }
+    m::mBool is_settingLayout() const
+    {
+        return is_replaying() && m_isSettingLayout;
+    }
+    // Set when a recording can not be replayed in this window
+    m::mBool has_failed() const { return m_hasFailed; }
+
+    // To call before ImGui::NewFrame
+    void feed_input(ImGuiIO &a_io);
+    // To call once the parameter panels are exposed, overrides the edits made
+    // through the panels. Returns true if the isopleths have to be rebuilt.
+    m::mBool apply_parameters(GridParameters           &a_gp,
+                              PressureLineParameters   &a_plp,
+                              VaporLineParameters      &a_vlp,
+                              PseudoAdiabatsParameters &a_pap) const;
+    // To call once the climatology panel is exposed, overrides its state and
+    // its button presses
+    void     apply_climatology(ClimatologyParameters &a_cp) const;
+    void     end_frame(std::chrono::steady_clock::duration const &a_frameTime);
+
+   private:
+    void report_scenario() const;
+
+    std::vector<InputRecording>                      m_recordings;
+    std::vector<std::chrono::steady_clock::duration> m_frameTimes;
+    m::mUInt                                         m_scenario{0};
+    m::mUInt                                         m_frame{0};
+    m::mBool                                         m_isSettingLayout{true};
+    m::mBool                                         m_hasFailed{false};
+};
@@ -0,0 +1,865 @@
+// Sockets headers first, winsock2.h has to come before windows.h
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "RenderServer.hpp"
+
+#include "Chart.hpp"
+#include "ChartParameters.hpp"
+#include "Sounding.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <exception>
+#include <sstream>
+#include <string_view>
+
+using namespace m;
+
+namespace
+{
+#ifdef _WIN32
+using NativeSocket                  = SOCKET;
+using PollFd                        = WSAPOLLFD;
+const std::intptr_t g_invalidSocket = std::intptr_t(INVALID_SOCKET);
+const short         g_pollIn        = POLLRDNORM;
+#else
+using NativeSocket                  = int;
+using PollFd                        = pollfd;
+const std::intptr_t g_invalidSocket = -1;
+const short         g_pollIn        = POLLIN;
+#endif
+
+// A client closing before reading its response must not raise SIGPIPE, it
+// would kill the app. Platforms without MSG_NOSIGNAL use SO_NOSIGPIPE.
+#ifdef MSG_NOSIGNAL
+const int g_sendFlags = MSG_NOSIGNAL;
+#else
+const int g_sendFlags = 0;
+#endif
+
+// Room for about a million levels, the point budget is reached first
+const std::size_t g_maxRequestSize   = 16 * 1024 * 1024;
+const std::size_t g_nbLatencySamples = 4096;
+const std::size_t g_maxNbConnections = 64;
+const mInt        g_pollMs           = 100;
+// Connections silent for that long are closed, requests that take longer to
+// be received too
+const mInt        g_idleTimeoutMs    = 5000;
+const mInt        g_requestTimeoutMs = 30000;
+// A client that stops reading can not hold a worker forever
+const mInt        g_sendTimeoutMs    = 5000;
+const mFloat      g_maxCanvasSize    = 8192;
+// Bounds the work and the response size of one request, the largest charts
+// editable in the app are well below
+const mDouble     g_maxNbPoints      = 2000000;
+const ImVec2      g_sizePadding      = {20, 20};  // Same as the app
+
+void close_socket(std::intptr_t const a_socket)
+{
+#ifdef _WIN32
+    closesocket(NativeSocket(a_socket));
+#else
+    close(NativeSocket(a_socket));
+#endif
+}
+
+const std::string_view g_endOfRequest = "\nend\n";
+
+mInt poll_sockets(std::vector<PollFd> &a_pollFds, mInt const a_timeoutMs)
+{
+#ifdef _WIN32
+    return WSAPoll(a_pollFds.data(), ULONG(a_pollFds.size()), a_timeoutMs);
+#else
+    return poll(a_pollFds.data(), nfds_t(a_pollFds.size()), a_timeoutMs);
+#endif
+}
+
+// Connected loopback sockets, a portable socketpair
+mBool create_socketPair(std::intptr_t &a_outFirst, std::intptr_t &a_outSecond)
+{
+    NativeSocket listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (std::intptr_t(listenSocket) == g_invalidSocket)
+    {
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_port        = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressSize   = sizeof(address);
+    NativeSocket first      = NativeSocket(g_invalidSocket);
+    NativeSocket second     = NativeSocket(g_invalidSocket);
+    if (bind(listenSocket, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) == 0 &&
+        listen(listenSocket, 1) == 0 &&
+        getsockname(listenSocket, reinterpret_cast<sockaddr *>(&address),
+                    &addressSize) == 0)
+    {
+        first = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (std::intptr_t(first) != g_invalidSocket &&
+            connect(first, reinterpret_cast<sockaddr *>(&address),
+                    sizeof(address)) == 0)
+        {
+            second = accept(listenSocket, nullptr, nullptr);
+        }
+    }
+    close_socket(listenSocket);
+
+    // The peer of second must be first, not another local process
+    sockaddr_in firstAddress{};
+    sockaddr_in peerAddress{};
+    socklen_t   firstSize = sizeof(firstAddress);
+    socklen_t   peerSize  = sizeof(peerAddress);
+    if (std::intptr_t(second) == g_invalidSocket ||
+        getsockname(first, reinterpret_cast<sockaddr *>(&firstAddress),
+                    &firstSize) != 0 ||
+        getpeername(second, reinterpret_cast<sockaddr *>(&peerAddress),
+                    &peerSize) != 0 ||
+        firstAddress.sin_port != peerAddress.sin_port)
+    {
+        if (std::intptr_t(first) != g_invalidSocket)
+        {
+            close_socket(first);
+        }
+        if (std::intptr_t(second) != g_invalidSocket)
+        {
+            close_socket(second);
+        }
+        return false;
+    }
+
+    a_outFirst  = first;
+    a_outSecond = second;
+    return true;
+}
+
+mBool send_all(std::intptr_t const a_socket, std::string const &a_data)
+{
+    std::size_t sent = 0;
+    while (sent < a_data.size())
+    {
+        auto result = send(NativeSocket(a_socket), a_data.data() + sent,
+                           mInt(std::min<std::size_t>(a_data.size() - sent,
+                                                      1 << 30)),
+                           g_sendFlags);
+        if (result <= 0)
+        {
+            return false;
+        }
+        sent += result;
+    }
+    return true;
+}
+
+// FNV-1a
+std::uint64_t get_hash(std::string const &a_data)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : a_data)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+char const *get_elementName(ChartElement const a_element)
+{
+    switch (a_element)
+    {
+        case ChartElement::canvas: return "canvas";
+        case ChartElement::background: return "background";
+        case ChartElement::grid: return "grid";
+        case ChartElement::pressure: return "pressure";
+        case ChartElement::vapor: return "vapor";
+        case ChartElement::pseudoAdiabat: return "pseudoAdiabat";
+        case ChartElement::sounding: return "sounding";
+    }
+    return "unknown";
+}
+
+void write_svgColor(std::ostream &a_stream, char const *a_attribute,
+                    ChartElement const a_element)
+{
+    ImVec4 color = get_chartColor(a_element);
+    a_stream << ' ' << a_attribute << "=\"rgb(" << mInt(color.x * 255) << ','
+             << mInt(color.y * 255) << ',' << mInt(color.z * 255) << ")\" "
+             << a_attribute << "-opacity=\"" << color.w << '"';
+}
+
+void write_svg(std::ostream &a_stream, ChartGeometry const &a_geometry,
+               ImVec2 const &a_canvasSize)
+{
+    ImVec2 const &sizeGraph = a_geometry.sizeGraph;
+
+    a_stream << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\""
+             << a_canvasSize.x << "\" height=\"" << a_canvasSize.y
+             << "\" viewBox=\"0 0 " << a_canvasSize.x << ' ' << a_canvasSize.y
+             << "\">\n";
+    a_stream << "<defs><clipPath id=\"graph\"><rect width=\"" << sizeGraph.x
+             << "\" height=\"" << sizeGraph.y << "\" y=\"" << -sizeGraph.y
+             << "\"/></clipPath></defs>\n";
+
+    a_stream << "<rect width=\"" << a_canvasSize.x << "\" height=\""
+             << a_canvasSize.y << '"';
+    write_svgColor(a_stream, "fill", ChartElement::canvas);
+    a_stream << "/>\n";
+
+    a_stream << "<g transform=\"translate(" << g_sizePadding.x << ','
+             << g_sizePadding.y + sizeGraph.y
+             << ")\" clip-path=\"url(#graph)\" fill=\"none\">\n";
+    a_stream << "<rect width=\"" << sizeGraph.x << "\" height=\""
+             << sizeGraph.y << "\" y=\"" << -sizeGraph.y << '"';
+    write_svgColor(a_stream, "fill", ChartElement::background);
+    a_stream << "/>\n";
+
+    for (ChartLine const &line : a_geometry.lines)
+    {
+        if (line.points.size() < 2)
+        {
+            continue;
+        }
+
+        a_stream << "<path d=\"";
+        // Pseudo adiabats are dashed, one segment every two points, as drawn
+        // by the app. A trailing lone point would be a move without segment.
+        mBool isDashed = line.element == ChartElement::pseudoAdiabat;
+        for (mUInt i = 0; i < line.points.size(); ++i)
+        {
+            if (isDashed && i % 2 == 0 && i + 1 == line.points.size())
+            {
+                break;
+            }
+            a_stream << (i == 0 || (isDashed && i % 2 == 0) ? 'M' : 'L')
+                     << line.points[i].x << ' ' << line.points[i].y << ' ';
+        }
+        a_stream << '"';
+        write_svgColor(a_stream, "stroke", line.element);
+        a_stream << " stroke-width=\""
+                 << (line.element == ChartElement::sounding ? 2 : 1)
+                 << "\"/>\n";
+    }
+
+    a_stream << "<g font-family=\"sans-serif\" font-size=\"13\" "
+                "dominant-baseline=\"hanging\"";
+    write_svgColor(a_stream, "fill", ChartElement::grid);
+    a_stream << ">\n";
+    for (ChartLabel const &label : a_geometry.labels)
+    {
+        a_stream << "<text x=\"" << label.position.x << "\" y=\""
+                 << label.position.y << "\">" << label.text << "</text>\n";
+    }
+    a_stream << "</g>\n</g>\n</svg>\n";
+}
+
+void write_geometry(std::ostream &a_stream, ChartGeometry const &a_geometry)
+{
+    a_stream << "size " << a_geometry.sizeGraph.x << ' '
+             << a_geometry.sizeGraph.y << '\n';
+    for (ChartLine const &line : a_geometry.lines)
+    {
+        a_stream << "line " << get_elementName(line.element) << ' '
+                 << line.points.size();
+        for (ImVec2 const &point : line.points)
+        {
+            a_stream << ' ' << point.x << ' ' << point.y;
+        }
+        a_stream << '\n';
+    }
+    for (ChartLabel const &label : a_geometry.labels)
+    {
+        a_stream << "label " << label.position.x << ' ' << label.position.y
+                 << ' ' << label.text << '\n';
+    }
+}
+
+// Guards the cache against parameters the validation let through
+mBool is_finite(ChartGeometry const &a_geometry)
+{
+    auto isFinite = [](ImVec2 const &a_point)
+    { return std::isfinite(a_point.x) && std::isfinite(a_point.y); };
+    for (ChartLine const &line : a_geometry.lines)
+    {
+        if (!std::all_of(line.points.begin(), line.points.end(), isFinite))
+        {
+            return false;
+        }
+    }
+    for (ChartLabel const &label : a_geometry.labels)
+    {
+        if (!isFinite(label.position))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pops the first line of a_text, without its '\n'
+std::string_view pop_line(std::string_view &a_text)
+{
+    std::size_t const lineEnd = std::min(a_text.find('\n'), a_text.size());
+    std::string_view  line    = a_text.substr(0, lineEnd);
+    a_text.remove_prefix(std::min(lineEnd + 1, a_text.size()));
+    return line;
+}
+
+std::string get_errorResponse(std::string const &a_message)
+{
+    return "error " + a_message + "\n";
+}
+}  // namespace
+
+mBool ResponseCache::get(std::uint64_t const a_hash, std::string const &a_key,
+                         std::string &a_outResponse)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(a_hash);
+    if (it == m_index.end() || it->second->key != a_key)
+    {
+        return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    a_outResponse = it->second->response;
+    return true;
+}
+
+void ResponseCache::put(std::uint64_t const a_hash, std::string const &a_key,
+                        std::string const &a_response)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::size_t nbBytes = a_key.size() + a_response.size();
+    if (nbBytes > m_maxBytes)
+    {
+        return;
+    }
+
+    auto it = m_index.find(a_hash);
+    if (it != m_index.end())
+    {
+        // Same request rendered concurrently, or a hash collision
+        m_nbBytes -= it->second->key.size() + it->second->response.size();
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    m_entries.push_front({a_hash, a_key, a_response});
+    m_index[a_hash] = m_entries.begin();
+    m_nbBytes += nbBytes;
+
+    while (m_entries.size() > m_capacity || m_nbBytes > m_maxBytes)
+    {
+        Entry const &last = m_entries.back();
+        m_nbBytes -= last.key.size() + last.response.size();
+        m_index.erase(last.hash);
+        m_entries.pop_back();
+    }
+}
+
+RenderServer::RenderServer()
+    : m_listenSocket(g_invalidSocket),
+      m_wakeSocket(g_invalidSocket),
+      m_pollerWakeSocket(g_invalidSocket)
+{
+}
+
+RenderServer::~RenderServer() { stop(); }
+
+mBool RenderServer::start(mUInt const a_port, mUInt const a_nbWorkers)
+{
+    if (m_running)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        return false;
+    }
+#endif
+
+    NativeSocket listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (std::intptr_t(listenSocket) == g_invalidSocket)
+    {
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<char const *>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(a_port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listenSocket, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+        listen(listenSocket, SOMAXCONN) != 0 ||
+        !create_socketPair(m_wakeSocket, m_pollerWakeSocket))
+    {
+        close_socket(listenSocket);
+        return false;
+    }
+
+    m_listenSocket = listenSocket;
+    m_startTime    = std::chrono::steady_clock::now();
+    m_running      = true;
+
+    m_poller = std::thread(&RenderServer::run_poller, this, m_listenSocket,
+                           m_pollerWakeSocket);
+    for (mUInt i = 0; i < std::max(a_nbWorkers, 1u); ++i)
+    {
+        m_workers.emplace_back(&RenderServer::run_worker, this);
+    }
+    return true;
+}
+
+void RenderServer::stop()
+{
+    {
+        // Under the lock, a worker can not miss the notification between its
+        // predicate check and its wait
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_queueCondition.notify_all();
+    wake_poller();
+
+    // The poller closes the connections it owns
+    m_poller.join();
+    close_socket(m_listenSocket);
+    m_listenSocket = g_invalidSocket;
+
+    // Workers wake the poller up until they are joined
+    for (std::thread &worker : m_workers) { worker.join(); }
+    m_workers.clear();
+    close_socket(m_wakeSocket);
+    close_socket(m_pollerWakeSocket);
+    m_wakeSocket       = g_invalidSocket;
+    m_pollerWakeSocket = g_invalidSocket;
+
+    for (ConnectionPtr const &connection : m_requests)
+    {
+        close_socket(connection->socket);
+    }
+    m_requests.clear();
+    for (ConnectionPtr const &connection : m_servedConnections)
+    {
+        close_socket(connection->socket);
+    }
+    m_servedConnections.clear();
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+RenderServerMetrics RenderServer::get_metrics() const
+{
+    RenderServerMetrics metrics;
+    metrics.nbRequests  = m_nbRequests;
+    metrics.nbCacheHits = m_nbCacheHits;
+    metrics.nbErrors    = m_nbErrors;
+
+    std::chrono::duration<mDouble> elapsed =
+        std::chrono::steady_clock::now() - m_startTime;
+    if (m_running && elapsed.count() > 0.0)
+    {
+        metrics.throughput = metrics.nbRequests / elapsed.count();
+    }
+
+    std::vector<mDouble> latencies;
+    {
+        std::lock_guard<std::mutex> lock(m_latencyMutex);
+        latencies = m_latencies;
+    }
+    if (!latencies.empty())
+    {
+        std::sort(latencies.begin(), latencies.end());
+        metrics.latencyP50 = latencies[(latencies.size() - 1) / 2];
+        metrics.latencyP99 = latencies[(latencies.size() - 1) * 99 / 100];
+    }
+    return metrics;
+}
+
+void RenderServer::run_poller(SocketHandle const a_listenSocket,
+                              SocketHandle const a_wakeSocket)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Connections receiving a request, the others are in the request queue or
+    // served by a worker
+    std::vector<ConnectionPtr> connections;
+    std::size_t                nbConnectionsOut = 0;
+    std::vector<PollFd>        pollFds;
+    char                       chunk[65536];
+
+    auto closeConnection = [](ConnectionPtr &a_connection)
+    {
+        close_socket(a_connection->socket);
+        a_connection.reset();
+    };
+
+    while (m_running)
+    {
+        pollFds.clear();
+        pollFds.push_back({NativeSocket(a_wakeSocket), g_pollIn, 0});
+        pollFds.push_back({NativeSocket(a_listenSocket), g_pollIn, 0});
+        for (ConnectionPtr const &connection : connections)
+        {
+            pollFds.push_back({NativeSocket(connection->socket), g_pollIn, 0});
+        }
+        if (poll_sockets(pollFds, g_pollMs) < 0)
+        {
+            continue;
+        }
+        auto const now = Clock::now();
+
+        for (std::size_t i = 0; i < connections.size(); ++i)
+        {
+            ConnectionPtr &connection = connections[i];
+            if (pollFds[i + 2].revents == 0)
+            {
+                if (now - connection->lastReceive >
+                        std::chrono::milliseconds(g_idleTimeoutMs) ||
+                    (connection->requestStart != Clock::time_point::min() &&
+                     now - connection->requestStart >
+                         std::chrono::milliseconds(g_requestTimeoutMs)))
+                {
+                    closeConnection(connection);
+                }
+                continue;
+            }
+
+            auto received = recv(NativeSocket(connection->socket), chunk,
+                                 sizeof(chunk), 0);
+            if (received <= 0)
+            {
+                closeConnection(connection);
+                continue;
+            }
+            connection->lastReceive = now;
+            if (connection->requestStart == Clock::time_point::min())
+            {
+                connection->requestStart = now;
+            }
+
+            // Only the new bytes can complete the end marker
+            std::size_t searchStart =
+                connection->buffer.size() -
+                std::min(connection->buffer.size(), g_endOfRequest.size() - 1);
+            connection->buffer.append(chunk, received);
+            if (connection->buffer.find(g_endOfRequest, searchStart) !=
+                std::string::npos)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_queueMutex);
+                    m_requests.push_back(std::move(connection));
+                }
+                m_queueCondition.notify_one();
+                ++nbConnectionsOut;
+            }
+            else if (connection->buffer.size() > g_maxRequestSize)
+            {
+                send_all(connection->socket,
+                         get_errorResponse("request too large"));
+                closeConnection(connection);
+            }
+        }
+        std::erase(connections, nullptr);
+
+        if (pollFds[0].revents != 0)
+        {
+            recv(NativeSocket(a_wakeSocket), chunk, sizeof(chunk), 0);
+
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            for (ConnectionPtr &connection : m_servedConnections)
+            {
+                --nbConnectionsOut;
+                if (connection->isClosed)
+                {
+                    closeConnection(connection);
+                    continue;
+                }
+                connection->lastReceive = now;
+                connections.push_back(std::move(connection));
+            }
+            m_servedConnections.clear();
+        }
+
+        if (pollFds[1].revents != 0)
+        {
+            NativeSocket clientSocket =
+                accept(NativeSocket(a_listenSocket), nullptr, nullptr);
+            if (std::intptr_t(clientSocket) == g_invalidSocket)
+            {
+                continue;
+            }
+            if (connections.size() + nbConnectionsOut >= g_maxNbConnections)
+            {
+                close_socket(clientSocket);
+                continue;
+            }
+
+#ifdef _WIN32
+            DWORD timeout = g_sendTimeoutMs;
+#else
+            timeval timeout{g_sendTimeoutMs / 1000,
+                            (g_sendTimeoutMs % 1000) * 1000};
+#endif
+            setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO,
+                       reinterpret_cast<char const *>(&timeout),
+                       sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt(clientSocket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+                       sizeof(noSigPipe));
+#endif
+
+            // Latency of the first request includes the wait for a worker
+            ConnectionPtr &connection = connections.emplace_back(
+                std::make_unique<Connection>());
+            connection->socket       = clientSocket;
+            connection->requestStart = now;
+            connection->lastReceive  = now;
+        }
+    }
+
+    for (ConnectionPtr &connection : connections)
+    {
+        closeConnection(connection);
+    }
+}
+
+void RenderServer::run_worker()
+{
+    while (true)
+    {
+        ConnectionPtr connection;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(
+                lock, [this] { return !m_running || !m_requests.empty(); });
+            if (!m_running)
+            {
+                return;
+            }
+            connection = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        serve_request(*connection);
+
+        // A pipelined request goes back in the queue, behind the other
+        // clients, the poller receives the next one otherwise
+        mBool const hasRequest =
+            !connection->isClosed &&
+            connection->buffer.find(g_endOfRequest) != std::string::npos;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (hasRequest)
+            {
+                m_requests.push_back(std::move(connection));
+            }
+            else
+            {
+                m_servedConnections.push_back(std::move(connection));
+            }
+        }
+        if (hasRequest)
+        {
+            m_queueCondition.notify_one();
+        }
+        else
+        {
+            wake_poller();
+        }
+    }
+}
+
+void RenderServer::serve_request(Connection &a_connection)
+{
+    std::size_t const requestEnd = a_connection.buffer.find(g_endOfRequest);
+
+    std::string response;
+    try
+    {
+        response = handle_request(
+            std::string_view(a_connection.buffer).substr(0, requestEnd + 1));
+    }
+    catch (std::exception const &e)
+    {
+        // Out of memory most likely, the app keeps running
+        ++m_nbErrors;
+        response = get_errorResponse(std::string("internal ") + e.what());
+    }
+    a_connection.buffer.erase(0, requestEnd + g_endOfRequest.size());
+
+    if (!send_all(a_connection.socket, response))
+    {
+        a_connection.isClosed = true;
+        return;
+    }
+    record_latency(std::chrono::steady_clock::now() -
+                   a_connection.requestStart);
+
+    // A pipelined request was received with the previous one, or the next
+    // request starts with its first received byte
+    a_connection.requestStart =
+        a_connection.buffer.empty()
+            ? std::chrono::steady_clock::time_point::min()
+            : a_connection.lastReceive;
+}
+
+void RenderServer::wake_poller()
+{
+    char const byte = 0;
+    send(NativeSocket(m_wakeSocket), &byte, 1, g_sendFlags);
+}
+
+// The request is parsed in place, only the header lines are copied. The
+// levels are kept once, in the vector and in binary in the cache key.
+std::string RenderServer::handle_request(std::string_view a_request)
+{
+    ++m_nbRequests;
+
+    std::istringstream renderLine{std::string(pop_line(a_request))};
+    std::string        tag;
+    std::string        format;
+    ImVec2             canvasSize;
+    if (!(renderLine >> tag >> format >> canvasSize.x >> canvasSize.y) ||
+        tag != "render" || (format != "svg" && format != "geometry") ||
+        !(canvasSize.x > 2 * g_sizePadding.x &&
+          canvasSize.x <= g_maxCanvasSize) ||
+        !(canvasSize.y > 2 * g_sizePadding.y &&
+          canvasSize.y <= g_maxCanvasSize))
+    {
+        ++m_nbErrors;
+        return get_errorResponse("expected render <svg|geometry> <w> <h>");
+    }
+
+    std::istringstream       paramsLine{std::string(pop_line(a_request))};
+    GridParameters           gp;
+    PressureLineParameters   plp;
+    VaporLineParameters      vlp;
+    PseudoAdiabatsParameters pap;
+    if (!(paramsLine >> tag) || tag != "params" ||
+        !read_chartParameters(paramsLine, gp, plp, vlp, pap))
+    {
+        ++m_nbErrors;
+        return get_errorResponse("invalid params");
+    }
+
+    std::istringstream soundingLine{std::string(pop_line(a_request))};
+    std::size_t        nbLevels = 0;
+    if (!(soundingLine >> tag >> nbLevels) || tag != "sounding")
+    {
+        ++m_nbErrors;
+        return get_errorResponse("expected sounding <nbLevels>");
+    }
+
+    ImVec2 const sizeGraph = canvasSize - g_sizePadding - g_sizePadding;
+    if (get_chartGeometryNbPoints(gp, plp, vlp, pap, sizeGraph) + nbLevels >
+        g_maxNbPoints)
+    {
+        ++m_nbErrors;
+        return get_errorResponse("chart too complex");
+    }
+
+    // Remaining lines up to the end marker
+    std::vector<SoundingLevel> levels;
+    levels.reserve(nbLevels);
+    if (!parse_soundingLevels(a_request, levels) || levels.size() != nbLevels)
+    {
+        ++m_nbErrors;
+        return get_errorResponse("invalid sounding levels");
+    }
+
+    // Canonical request, independent of the formatting of the client
+    std::ostringstream header;
+    header << std::setprecision(9) << format << ' ' << canvasSize.x << ' '
+           << canvasSize.y << '\n';
+    write_chartParameters(header, gp, plp, vlp, pap);
+    header << '\n';
+    std::string key = std::move(header).str();
+    key.append(reinterpret_cast<char const *>(levels.data()),
+               levels.size() * sizeof(SoundingLevel));
+    std::uint64_t const hash = get_hash(key);
+
+    std::string response;
+    if (m_cache.get(hash, key, response))
+    {
+        ++m_nbCacheHits;
+        return response;
+    }
+
+    ChartGeometry  geometry;
+    ChartIsopleths isopleths;
+    mBool          isoplethsDirty = true;
+    build_chartGeometry(geometry, isopleths, isoplethsDirty, gp, plp, vlp, pap,
+                        sizeGraph);
+    add_soundingLine(geometry, levels, gp);
+    if (!is_finite(geometry))
+    {
+        ++m_nbErrors;
+        return get_errorResponse("chart not finite");
+    }
+
+    std::ostringstream payload;
+    if (format == "svg")
+    {
+        write_svg(payload, geometry, canvasSize);
+    }
+    else
+    {
+        write_geometry(payload, geometry);
+    }
+
+    std::string const payloadString = std::move(payload).str();
+    response = "ok " + std::to_string(payloadString.size()) + "\n";
+    response += payloadString;
+    m_cache.put(hash, key, response);
+    return response;
+}
+
+void RenderServer::record_latency(
+    std::chrono::steady_clock::duration const a_latency)
+{
+    mDouble latency =
+        std::chrono::duration<mDouble, std::micro>(a_latency).count();
+
+    std::lock_guard<std::mutex> lock(m_latencyMutex);
+    if (m_latencies.size() < g_nbLatencySamples)
+    {
+        m_latencies.push_back(latency);
+    }
+    else
+    {
+        m_latencies[m_nextLatency] = latency;
+        m_nextLatency              = (m_nextLatency + 1) % g_nbLatencySamples;
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Least recently used cache of rendered responses, thread safe
+// Bounded in number of entries and in bytes, responses bigger than the byte
+// budget are not cached.
+class ResponseCache
+{
+   public:
+    ResponseCache(std::size_t const a_capacity, std::size_t const a_maxBytes)
+        : m_capacity(a_capacity), m_maxBytes(a_maxBytes)
+    {
+    }
+
+    // a_key is the canonical request, compared on hash match to rule out
+    // collisions
+    m::mBool get(std::uint64_t const a_hash, std::string const &a_key,
+                 std::string &a_outResponse);
+    void     put(std::uint64_t const a_hash, std::string const &a_key,
+                 std::string const &a_response);
+
+   private:
+    struct Entry
+    {
+        std::uint64_t hash;
+        std::string   key;
+        std::string   response;
+    };
+
+    std::mutex                                                    m_mutex;
+    std::size_t                                                   m_capacity;
+    std::size_t                                                   m_maxBytes;
+    std::size_t                                                   m_nbBytes{0};
+    std::list<Entry>                                              m_entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> m_index;
+};
+
+struct RenderServerMetrics
+{
+    std::size_t nbRequests{0};
+    std::size_t nbCacheHits{0};
+    std::size_t nbErrors{0};
+    m::mDouble  throughput{0.0};  // requests/s since start
+    m::mDouble  latencyP50{0.0};  // µs
+    m::mDouble  latencyP99{0.0};  // µs
+};
+
+// Renders charts on demand for local clients.
+//
+// Listens on 127.0.0.1:<port>, one text request per message:
+//   render <svg|geometry> <width> <height>
+//   params <chart parameters, see write_chartParameters>
+//   sounding <nbLevels>
+//   <pressure(kPa)> <temperature(°C)>   (nbLevels lines)
+//   end
+// Answers "ok <nbBytes>\n<payload>" or "error <message>\n". Several requests
+// can be sent on the same connection.
+//
+// A poller thread receives the requests of all the connections, complete
+// requests are queued and served by a pool of workers. A connection has at most
+// one request in the queue, responses keep the order of its requests. Responses
+// are cached on a hash of the canonical request.
+class RenderServer
+{
+   public:
+    RenderServer();
+    ~RenderServer();
+
+    m::mBool start(m::mUInt const a_port, m::mUInt const a_nbWorkers);
+    void     stop();
+    m::mBool is_running() const { return m_running; }
+
+    RenderServerMetrics get_metrics() const;
+
+   private:
+    using SocketHandle = std::intptr_t;
+
+    // Owned by the poller while a request is received, by the request queue
+    // or a worker once it is complete
+    struct Connection
+    {
+        SocketHandle                          socket;
+        std::string                           buffer;  // not served yet
+        // Accept or first received byte of the pending request, min() when
+        // no byte of it was received
+        std::chrono::steady_clock::time_point requestStart;
+        std::chrono::steady_clock::time_point lastReceive;
+        m::mBool                              isClosed{false};
+    };
+    using ConnectionPtr = std::unique_ptr<Connection>;
+
+    // The poller works on its own copies of the listen and wake sockets,
+    // closed by stop once the poller is joined
+    void run_poller(SocketHandle const a_listenSocket,
+                    SocketHandle const a_wakeSocket);
+    void run_worker();
+    // Serves the first request of the connection buffer
+    void serve_request(Connection &a_connection);
+    void wake_poller();
+
+    std::string handle_request(std::string_view a_request);
+    void record_latency(std::chrono::steady_clock::duration const a_latency);
+
+    std::atomic<m::mBool> m_running{false};
+    SocketHandle          m_listenSocket;
+    // Written by the workers to wake the poller up, read by the poller
+    SocketHandle          m_wakeSocket;
+    SocketHandle          m_pollerWakeSocket;
+
+    std::thread              m_poller;
+    std::vector<std::thread> m_workers;
+
+    std::mutex                 m_queueMutex;  // also guards m_running writes
+    std::condition_variable    m_queueCondition;
+    // Connections with a complete request
+    std::deque<ConnectionPtr>  m_requests;
+    // Served connections handed back to the poller
+    std::vector<ConnectionPtr> m_servedConnections;
+
+    ResponseCache m_cache{256, 64 * 1024 * 1024};
+
+    std::chrono::steady_clock::time_point m_startTime;
+    std::atomic<std::size_t>              m_nbRequests{0};
+    std::atomic<std::size_t>              m_nbCacheHits{0};
+    std::atomic<std::size_t>              m_nbErrors{0};
+
+    mutable std::mutex      m_latencyMutex;
+    // µs, from accept or first received byte to response sent, ring of the
+    // last requests
+    std::vector<m::mDouble> m_latencies;
+    std::size_t             m_nextLatency{0};
+};
@@ -0,0 +1,100 @@
+#include "Sounding.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
+using namespace m;
+
+namespace
+{
+char const *skip_blanks(char const *a_begin, char const *a_end)
+{
+    while (a_begin != a_end && (*a_begin == ' ' || *a_begin == '\t' ||
+                                *a_begin == '\r' || *a_begin == ','))
+    {
+        ++a_begin;
+    }
+    return a_begin;
+}
+}  // namespace
+
+mBool parse_soundingLevels(std::string_view const      a_text,
+                           std::vector<SoundingLevel> &a_levels)
+{
+    char const *current = a_text.data();
+    char const *end     = a_text.data() + a_text.size();
+    while (current != end)
+    {
+        char const *lineEnd = std::find(current, end, '\n');
+        char const *cursor  = skip_blanks(current, lineEnd);
+        if (cursor != lineEnd && *cursor != '#')
+        {
+            SoundingLevel level;
+            auto [pressureEnd, pressureError] =
+                std::from_chars(cursor, lineEnd, level.pressure);
+            cursor = skip_blanks(pressureEnd, lineEnd);
+            auto [temperatureEnd, temperatureError] =
+                std::from_chars(cursor, lineEnd, level.temperature);
+            // from_chars accepts nan and inf
+            if (pressureError != std::errc() ||
+                temperatureError != std::errc() ||
+                !std::isfinite(level.pressure) ||
+                !std::isfinite(level.temperature))
+            {
+                return false;
+            }
+            a_levels.push_back(level);
+        }
+        current = lineEnd == end ? end : lineEnd + 1;
+    }
+
+    return true;
+}
+
+mBool load_soundingLevels(
+    std::string const                                              &a_path,
+    std::function<void(std::vector<SoundingLevel> const &)> const &a_onLevels)
+{
+    static const std::size_t s_chunkSize = 4 * 1024 * 1024;
+
+    std::ifstream file(a_path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Starts with the unfinished last line of the previous chunk
+    std::string                buffer;
+    std::vector<SoundingLevel> levels;
+    while (file)
+    {
+        std::size_t const pending = buffer.size();
+        buffer.resize(pending + s_chunkSize);
+        file.read(buffer.data() + pending, s_chunkSize);
+        buffer.resize(pending + std::size_t(file.gcount()));
+
+        std::size_t parsedEnd =
+            file ? buffer.rfind('\n') + 1 : buffer.size();  // npos + 1 is 0
+        if (parsedEnd == 0 && buffer.size() > s_chunkSize)
+        {
+            // A line longer than a chunk is not a level
+            return false;
+        }
+
+        levels.clear();
+        if (!parse_soundingLevels(std::string_view(buffer).substr(0, parsedEnd),
+                                  levels))
+        {
+            return false;
+        }
+        if (!levels.empty())
+        {
+            a_onLevels(levels);
+        }
+        buffer.erase(0, parsedEnd);
+    }
+
+    return !file.bad();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct SoundingLevel
+{
+    m::mFloat pressure;     // kPa
+    m::mFloat temperature;  // °C
+};
+
+// One "pressure(kPa) temperature(°C)" pair per line. Empty lines and lines
+// starting with '#' are skipped, they can be used to separate soundings.
+// Levels are appended to a_levels.
+m::mBool parse_soundingLevels(std::string_view const      a_text,
+                              std::vector<SoundingLevel> &a_levels);
+// Reads the file in chunks of whole lines, a_onLevels gets the levels of each
+// chunk so that memory does not grow with the file size
+m::mBool load_soundingLevels(
+    std::string const                                              &a_path,
+    std::function<void(std::vector<SoundingLevel> const &)> const &a_onLevels);
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Thermodynamics.hpp"
+
+#include <algorithm>
+#include <array>
+
+// Isopleths of the default chart, baked at compile time in data space
+// (temperature °C, phi °K) so that the first frame needs no runtime physics.
+namespace standardChart
+{
+using namespace m;
+using namespace thermodynamics;
+
+struct DataPoint
+{
+    mFloat temperature;  // °C
+    mFloat phi;          // °K
+};
+
+template <mUInt t_nbLines, mUInt t_nbPoints>
+using Lines = std::array<std::array<DataPoint, t_nbPoints>, t_nbLines>;
+
+// Grid
+inline constexpr mFloat g_minTemp     = -37.5f;  // °C
+inline constexpr mFloat g_maxTemp     = 15.0f;   // °C
+inline constexpr mInt   g_divTemp     = 6;
+inline constexpr mFloat g_minPhi      = 285.0f;  // °K
+inline constexpr mFloat g_maxPhi      = 345.0f;  // °K
+inline constexpr mInt   g_divPhi      = 5;
+inline constexpr mFloat g_rotation    = 0.25f;  // rad
+inline constexpr mFloat g_minRotation = 0.01f;  // rad
+inline constexpr mFloat g_maxRotation = 0.45f;  // rad
+
+inline constexpr mFloat g_deltaTemp =
+    (g_maxTemp - g_minTemp) / (g_divTemp + 1);
+
+// Temperature samples run past the grid bounds on both sides to cover the
+// tilted grid, up to g_maxRotation on the default canvas.
+inline constexpr mInt g_tempMargin    = 27;
+inline constexpr mInt g_nbTempSamples = g_divTemp + 2 * g_tempMargin + 2;
+
+// Pressure lines
+inline constexpr mInt   g_nbPressureLines = 10;
+inline constexpr mFloat g_maxPressure     = 100.0f;  // kPa
+inline constexpr mFloat g_deltaPressure   = 10.0f;   // kPa
+
+// Vapor lines
+inline constexpr mInt                               g_nbVaporLines = 10;
+inline constexpr std::array<mFloat, g_nbVaporLines> g_wss{
+    1.0f, 1.5f, 2.0f, 3.0f, 5.0f, 7.0f, 10.0f, 15.0f, 20.0f, 30.0f};  // g/kg
+// The saturation formula diverges near -243.5°C, colder samples are clamped,
+// far out of the visible chart anyway
+inline constexpr mFloat g_minVaporTemp = -100.0f;  // °C
+
+// Pseudo adiabats
+inline constexpr mInt   g_nbPseudoAdiabats           = 8;
+inline constexpr mFloat g_minPseudoAdiabatTemp       = -4.0f;  // °C
+inline constexpr mFloat g_deltaPseudoAdiabatTemp     = 4.0f;   // °C
+inline constexpr mInt   g_pseudoAdiabatSubdivisions  = 100;
+inline constexpr mFloat g_pseudoAdiabatStartPressure = 100.0f;  // kPa
+inline constexpr mFloat g_pseudoAdiabatGoalPressure  = 10.0f;   // kPa
+
+// Temperature of the a_index sample, a_index 0 is g_tempMargin divisions
+// below g_minTemp
+constexpr mDouble get_sampleTemperature(mInt const a_index)
+{
+    return g_minTemp + g_deltaTemp * (a_index - g_tempMargin);
+}
+
+constexpr Lines<g_nbPressureLines, g_nbTempSamples> bake_pressureLines()
+{
+    Lines<g_nbPressureLines, g_nbTempSamples> lines{};
+    for (mInt k = 0; k < g_nbPressureLines; ++k)
+    {
+        mDouble pressure = g_maxPressure - k * g_deltaPressure;
+        for (mInt i = 0; i < g_nbTempSamples; ++i)
+        {
+            mDouble temperature = get_sampleTemperature(i);
+            lines[k][i]         = {mFloat(temperature),
+                                   mFloat(ce_get_phi(temperature, pressure))};
+        }
+    }
+    return lines;
+}
+
+constexpr Lines<g_nbVaporLines, g_nbTempSamples> bake_vaporLines()
+{
+    Lines<g_nbVaporLines, g_nbTempSamples> lines{};
+    for (mInt k = 0; k < g_nbVaporLines; ++k)
+    {
+        for (mInt i = 0; i < g_nbTempSamples; ++i)
+        {
+            mDouble temperature =
+                std::max(get_sampleTemperature(i), mDouble(g_minVaporTemp));
+            mDouble pressure =
+                ce_get_pressureFromWandTemperature(g_wss[k], temperature);
+            lines[k][i] = {mFloat(temperature),
+                           mFloat(ce_get_phi(temperature, pressure))};
+        }
+    }
+    return lines;
+}
+
+constexpr Lines<g_nbPseudoAdiabats, g_pseudoAdiabatSubdivisions>
+bake_pseudoAdiabats()
+{
+    Lines<g_nbPseudoAdiabats, g_pseudoAdiabatSubdivisions> lines{};
+    mDouble deltaP =
+        mDouble(g_pseudoAdiabatGoalPressure - g_pseudoAdiabatStartPressure) /
+        g_pseudoAdiabatSubdivisions;
+    for (mInt k = 0; k < g_nbPseudoAdiabats; ++k)
+    {
+        mDouble temperature =
+            g_minPseudoAdiabatTemp + g_deltaPseudoAdiabatTemp * k;
+        mDouble pressure = g_pseudoAdiabatStartPressure;
+        for (mInt d = 0; d < g_pseudoAdiabatSubdivisions; ++d)
+        {
+            lines[k][d] = {mFloat(temperature),
+                           mFloat(ce_get_phi(temperature, pressure))};
+
+            temperature +=
+                ce_get_pseudoAdiabatDeltaT(temperature, pressure, deltaP);
+            pressure += deltaP;
+        }
+    }
+    return lines;
+}
+
+inline constexpr auto g_pressureLines  = bake_pressureLines();
+inline constexpr auto g_vaporLines     = bake_vaporLines();
+inline constexpr auto g_pseudoAdiabats = bake_pseudoAdiabats();
+}  // namespace standardChart
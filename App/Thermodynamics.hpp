@@ -0,0 +1,183 @@
+#pragma once
+
+#include <MesumCore/Kernel/Kernel.hpp>
+
+#include <cmath>
+
+namespace thermodynamics
+{
+using namespace m;
+
+inline constexpr mFloat g_k   = 0.286f;
+inline constexpr mFloat g_c2k = 273.15f;
+inline constexpr mFloat g_eps = 0.622f;  // R'/Rv
+
+inline constexpr mFloat g_cp = 1005.0f;  // J*kg-1*K-1
+inline constexpr mFloat g_L  = 2500000.0f;  // J*kg-1
+
+inline constexpr mFloat g_A = 253000000.0f;  // kPa
+inline constexpr mFloat g_B = 5420.0f;       // °K
+
+// Compile time replacements for <cmath>, which is not constexpr in C++20.
+// Only meant to be used to bake tables, precision is close to the double one.
+namespace ce
+{
+inline constexpr mDouble g_ln2 = 0.693147180559945309417;
+
+constexpr mDouble exp(mDouble const a_x)
+{
+    // exp(x) = 2^n * exp(r), |r| <= ln2/2
+    mInt    n = mInt(a_x / g_ln2 + (a_x < 0 ? -0.5 : 0.5));
+    mDouble r = a_x - n * g_ln2;
+
+    mDouble term   = 1.0;
+    mDouble result = 1.0;
+    for (mInt i = 1; i < 20; ++i)
+    {
+        term *= r / i;
+        result += term;
+    }
+
+    for (; n > 0; --n) { result *= 2.0; }
+    for (; n < 0; ++n) { result *= 0.5; }
+    return result;
+}
+
+constexpr mDouble log(mDouble const a_x)
+{
+    // log(x) = n * ln2 + log(m), m in [0.75, 1.5)
+    mDouble mantissa = a_x;
+    mInt    n        = 0;
+    while (mantissa >= 1.5)
+    {
+        mantissa *= 0.5;
+        ++n;
+    }
+    while (mantissa < 0.75)
+    {
+        mantissa *= 2.0;
+        --n;
+    }
+
+    // log(m) = 2 * atanh((m - 1) / (m + 1))
+    mDouble s      = (mantissa - 1.0) / (mantissa + 1.0);
+    mDouble s2     = s * s;
+    mDouble term   = s;
+    mDouble result = 0.0;
+    for (mInt i = 1; i < 40; i += 2)
+    {
+        result += term / i;
+        term *= s2;
+    }
+
+    return n * g_ln2 + 2.0 * result;
+}
+
+constexpr mDouble pow(mDouble const a_x, mDouble const a_y)
+{
+    return exp(a_y * log(a_x));
+}
+}  // namespace ce
+
+// Math functions used by the formulas below, <cmath> at runtime, ce::Math to
+// bake tables at compile time
+struct StdMath
+{
+    template <typename t_Real>
+    static t_Real exp(t_Real const a_x)
+    {
+        return std::exp(a_x);
+    }
+
+    template <typename t_Real>
+    static t_Real pow(t_Real const a_x, t_Real const a_y)
+    {
+        return std::pow(a_x, a_y);
+    }
+};
+
+namespace ce
+{
+struct Math
+{
+    static constexpr mDouble exp(mDouble const a_x) { return ce::exp(a_x); }
+    static constexpr mDouble pow(mDouble const a_x, mDouble const a_y)
+    {
+        return ce::pow(a_x, a_y);
+    }
+};
+}  // namespace ce
+
+// temperature °C, pressure kPa
+template <typename t_Math, typename t_Real>
+constexpr t_Real get_phi(t_Real const a_temperature, t_Real const a_pressure)
+{
+    return (a_temperature + t_Real(273.15)) *
+           t_Math::pow(t_Real(100) / a_pressure, t_Real(g_k));
+}
+
+// temperature °C, pressure kPa, ws g/kg
+template <typename t_Math, typename t_Real>
+constexpr t_Real get_pressureFromWandTemperature(t_Real const a_ws,
+                                                 t_Real const a_temperature)
+{
+    return ((1000 * t_Real(g_eps) - a_ws) / (10 * a_ws)) * t_Real(6.112) *
+           t_Math::exp(t_Real(17.67) * a_temperature /
+                       (a_temperature + t_Real(243.5)));
+}
+
+// temperature °C, pressure kPa, deltaPressure kPa
+// Temperature change along a pseudo adiabat for a pressure step
+template <typename t_Math, typename t_Real>
+constexpr t_Real get_pseudoAdiabatDeltaT(t_Real const a_temperature,
+                                         t_Real const a_pressure,
+                                         t_Real const a_deltaPressure)
+{
+    t_Real tempK   = t_Real(g_c2k) + a_temperature;
+    t_Real eaexpbt = t_Real(g_eps) * t_Real(g_A) * t_Math::exp(-g_B / tempK);
+    return a_deltaPressure *
+           (g_k / a_pressure +
+            eaexpbt * g_L / (tempK * a_pressure * a_pressure * g_cp)) /
+           (1 / tempK + eaexpbt * g_B * g_L /
+                            (tempK * tempK * tempK * a_pressure * g_cp));
+}
+
+inline mFloat get_phi(mFloat const a_temperature, mFloat const a_pressure)
+{
+    return get_phi<StdMath>(a_temperature, a_pressure);
+}
+
+inline mFloat get_pressureFromWandTemperature(mFloat const a_ws,
+                                              mFloat const a_temperature)
+{
+    return get_pressureFromWandTemperature<StdMath>(a_ws, a_temperature);
+}
+
+inline mFloat get_pseudoAdiabatDeltaT(mFloat const a_temperature,
+                                      mFloat const a_pressure,
+                                      mFloat const a_deltaPressure)
+{
+    return get_pseudoAdiabatDeltaT<StdMath>(a_temperature, a_pressure,
+                                            a_deltaPressure);
+}
+
+constexpr mDouble ce_get_phi(mDouble const a_temperature,
+                             mDouble const a_pressure)
+{
+    return get_phi<ce::Math>(a_temperature, a_pressure);
+}
+
+constexpr mDouble ce_get_pressureFromWandTemperature(
+    mDouble const a_ws, mDouble const a_temperature)
+{
+    return get_pressureFromWandTemperature<ce::Math>(a_ws, a_temperature);
+}
+
+constexpr mDouble ce_get_pseudoAdiabatDeltaT(mDouble const a_temperature,
+                                             mDouble const a_pressure,
+                                             mDouble const a_deltaPressure)
+{
+    return get_pseudoAdiabatDeltaT<ce::Math>(a_temperature, a_pressure,
+                                             a_deltaPressure);
+}
+}  // namespace thermodynamics
@@ -8,8 +8,22 @@
 #include "RendererUtils.hpp"
 #include "RenderTasksBasicSwapchain.hpp"
 
+#include "Thermodynamics.hpp"
+#include "StandardChart.hpp"
+#include "ChartParameters.hpp"
+#include "Chart.hpp"
+#include "InputRecording.hpp"
+#include "DensityHistogram.hpp"
+#include "RenderServer.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <future>
 #include <iomanip>
+#include <iostream>
 #include <random>
+#include <string_view>
+#include <thread>
 #include <algorithm>
 #include <numbers>
 
@@ -26,45 +40,13 @@
 const m::logging::mChannelID m_Tephigram_ID = mLog_getId();
 
 using namespace m;
-
-static const mFloat g_k   = 0.286f;
-static const mFloat g_c2k = 273.15f;
-static const mFloat g_eps = 0.622f;  // R'/Rv
-
-static const mFloat g_cp = 1005.0f;  // J*kg-1*K-1
-
-static const mFloat g_A = 253000000.0f;  // kPa
-static const mFloat g_B = 5420.0f;       // °K
-
-ImVec2 operator+(ImVec2 const &a_r, ImVec2 const &a_l)
-{
-    return {a_r.x + a_l.x, a_r.y + a_l.y};
-}
-
-ImVec2 operator-(ImVec2 const &a_r, ImVec2 const &a_l)
-{
-    return {a_r.x - a_l.x, a_r.y - a_l.y};
-}
-
-// temperature °C, pressure kPa
-mFloat get_phi(mFloat const a_temperature, mFloat const a_pressure)
-{
-    return (a_temperature + 273.15) * std::pow((100 / a_pressure), g_k);
-}
+using namespace thermodynamics;
 
 mFloat get_pressure(mFloat const a_temperature, mFloat const a_phi)
 {
     return 100 / std::pow(a_phi / (a_temperature + g_c2k), 1 / g_k);
 }
 
-// temperature °C, pressure kPa, ws g/kg
-mFloat get_pressureFromWandTemperature(mFloat const a_ws,
-                                       mFloat const a_temperature)
-{
-    return ((1000 * g_eps - a_ws) / (10 * a_ws)) * 6.112 *
-           std::exp((17.67 * a_temperature / (a_temperature + 243.5)));
-}
-
 // temperature °C, pressure kPa, ws g/kg
 mFloat get_wsFromTemperatureAndPressure(mFloat const a_temperature,
                                         mFloat const a_pressure)
@@ -117,44 +99,6 @@ mFloat get_phiFromPos(ImVec2 const &a_position, ImVec2 const &a_boundsPhi,
 //     return {x, -y};
 // }
 
-ImVec2 get_posFromTempAndPhi(mFloat const a_temperature, mFloat const a_phi,
-                             ImVec2 const &a_boundsTemp,
-                             ImVec2 const &a_boundsPhi,
-                             ImVec2 const &a_sizeGraph,
-                             mFloat const  a_angleGraph)
-{
-    ImVec2 result{0.0f, 0.0f};
-    mFloat tempRatio =
-        (a_temperature - a_boundsTemp.x) / (a_boundsTemp.y - a_boundsTemp.x);
-    mFloat tephiRatio =
-        (a_phi - a_boundsPhi.x) / (a_boundsPhi.y - a_boundsPhi.x);
-
-    ImVec2 oT{tempRatio * a_sizeGraph.x, (-0.5f * a_sizeGraph.y)};
-    ImVec2 oPhi{0.5f * a_sizeGraph.x, -tephiRatio * a_sizeGraph.y};
-
-    mFloat alphaT   = std::sin(a_angleGraph);
-    mFloat alphaPhi = std::cos(a_angleGraph);
-    mFloat betaT    = -std::cos(a_angleGraph);
-    mFloat betaPhi  = std::sin(a_angleGraph);
-
-    mFloat tPhi = 0;
-    if (alphaT == 0)
-    {
-        result.x = oT.x;
-        result.y = oPhi.y;
-    }
-    else
-    {
-        tPhi = (oT.y + (betaT / alphaT) * (oPhi.x - oT.x) - oPhi.y) /
-               (betaPhi - betaT * (alphaPhi / alphaT));
-
-        result.x = oPhi.x + alphaPhi * tPhi;
-        result.y = oPhi.y + betaPhi * tPhi;
-    }
-
-    return result;
-}
-
 // temperature °C, pressure kPa
 ImVec2 get_posFromWandTemperature(mFloat const a_ws, mFloat const a_temperature,
                                   ImVec2 const &a_boundsTemperature,
@@ -170,136 +114,47 @@ ImVec2 get_posFromWandTemperature(mFloat const a_ws, mFloat const a_temperature,
                                  a_boundsPhi, a_sizeGraph, a_angleGraph);
 }
 
-mFloat get_yFromXandPressure(mFloat const a_x, mFloat const a_pressure,
-                             ImVec2 const &a_boundsTemperature,
-                             ImVec2 const &a_boundsPhi,
-                             ImVec2 const &a_sizeGraph, mFloat a_angleGraph)
-{
-    mFloat b      = 0.5 * a_sizeGraph.y;
-    mFloat b2     = 0.5 * a_sizeGraph.x;
-    mFloat sx     = a_sizeGraph.x;
-    mFloat sy     = a_sizeGraph.y;
-    mFloat mt     = a_boundsTemperature.x + g_c2k;
-    mFloat mphi   = a_boundsPhi.x;
-    mFloat dt     = a_boundsTemperature.y - a_boundsTemperature.x;
-    mFloat dphi   = a_boundsPhi.y - a_boundsPhi.x;
-    mFloat tan    = std::tan(a_angleGraph);
-    mFloat invTan = 1 / tan;
-    mFloat p      = std::pow(100 / a_pressure, g_k);
-    mFloat temperature =
-        (mphi +
-         (b + (a_x - b2) * tan + invTan * (mt * sx / dt + a_x)) * (dphi / sy)) /
-        (p + (dphi / sy) * invTan * sx / dt);
-    return -invTan * ((temperature - mt) * sx / dt - a_x) + b;
-}
-
-struct GridParameters
-{
-    ImVec2 boundTemp{-37.5, 15};  // °C
-    mInt   divTemp{6};
-    ImVec2 boundPhi{285, 345};  // °K
-    mInt   divPhi{5};
-
-    mFloat rotation{0.25};  // rad
-
-    void expose_dearImGui();
-};
-
-void GridParameters::expose_dearImGui()
-{
-    if (ImGui::TreeNode("Grid Parameters"))
-    {
-        ImGui::DragFloat2("Temperature Bounds (°C)", &boundTemp.x, 0.5, -50,
-                          50);
-        ImGui::DragInt("Temperature Subdivisions", &divTemp, 1, 0, 20);
-        ImGui::DragFloat2("Temperature Capacity Bounds (°K)", &boundPhi.x, 0.5,
-                          50, 700);
-        ImGui::DragInt("Temperature Capacity Subdivisions", &divPhi, 1, 0, 20);
-        ImGui::DragFloat("grid angle(rad)", &rotation, 0.01, 0.0, 0.45);
-        ImGui::TreePop();
-    }
-}
-
-struct PressureLineParameters
+void draw_chartGeometry(ImDrawList *a_drawList, ChartGeometry const &a_geometry,
+                        ImVec2 const &a_graphOrigin)
 {
-    mInt   nbPressureLine{10};
-    mFloat maxPressure{100};  // kPa
-    mFloat deltaPressure{10};
-
-    mBool showPressureLine{true};
-
-    void expose_dearImGui();
-};
-
-void PressureLineParameters::expose_dearImGui()
-{
-    if (ImGui::TreeNode("Pressure Lines"))
+    for (ChartLine const &line : a_geometry.lines)
     {
-        ImGui::Checkbox("Show Pressure Lines", &showPressureLine);
-
-        ImGui::DragInt("Nb Pressure Lines", &nbPressureLine, 1, 1, 10);
-        ImGui::DragFloat("Max Pressure (kPa)", &maxPressure, 1, 10, 100);
-        ImGui::DragFloat("Pressure Delta", &deltaPressure, 1, 1, 30);
-
-        ImGui::TreePop();
-    }
-}
-
-struct VaporLineParameters
-{
-    mInt                nbVaporLines{10};
-    std::vector<mFloat> wss{1.0f, 1.5f,  2.0f,  3.0f,  5.0f,
-                            7.0f, 10.0f, 15.0f, 20.0f, 30.0f};
-    mBool               showVaporLines{true};
-
-    void expose_dearImGui();
-};
-
-void VaporLineParameters::expose_dearImGui()
-{
-    if (ImGui::TreeNode("Vapor Lines"))
-    {
-        ImGui::Checkbox("Show vapor lines", &showVaporLines);
-
-        ImGui::DragInt("Nb Vapor lines", &nbVaporLines, 1, 1, 10);
-        if (wss.size() != nbVaporLines)
+        ImU32 color = ImColor(get_chartColor(line.element));
+        if (line.element == ChartElement::pseudoAdiabat)
         {
-            wss.resize(nbVaporLines);
+            // Dashed
+            for (mUInt i = 0; i + 1 < line.points.size(); i += 2)
+            {
+                a_drawList->AddLine(a_graphOrigin + line.points[i],
+                                    a_graphOrigin + line.points[i + 1], color,
+                                    1.0f);
+            }
+            continue;
         }
 
-        for (mUInt i = 0; i < wss.size(); ++i)
+        mFloat thickness = line.element == ChartElement::sounding ? 2.0f : 1.0f;
+        if (line.points.size() == 2)
         {
-            char name[16];
-            ImFormatString(name, 16, "ws %d", mInt(i));
-            ImGui::DragFloat(name, &wss[i], 0.01f, 0.1f, 100.0f);
+            a_drawList->AddLine(a_graphOrigin + line.points[0],
+                                a_graphOrigin + line.points[1], color,
+                                thickness);
+            continue;
         }
 
-        ImGui::TreePop();
+        std::vector<ImVec2> points(line.points.size());
+        for (mUInt i = 0; i < points.size(); ++i)
+        {
+            points[i] = a_graphOrigin + line.points[i];
+        }
+        a_drawList->AddPolyline(points.data(), points.size(), color, 0,
+                                thickness);
     }
-}
 
-struct PseudoAdiabatsParameters
-{
-    mInt   nbLine{8};
-    mFloat minTemp{-4};  // kPa
-    mFloat deltaTemp{4};
-
-    mBool showPseudoAdiabats{true};
-
-    void expose_dearImGui();
-};
-
-void PseudoAdiabatsParameters::expose_dearImGui()
-{
-    if (ImGui::TreeNode("Pseudo Adiabats"))
+    ImU32 colLabel = ImColor(get_chartColor(ChartElement::grid));
+    for (ChartLabel const &label : a_geometry.labels)
     {
-        ImGui::Checkbox("Show pseudo adiabats", &showPseudoAdiabats);
-
-        ImGui::DragInt("Nb pseudo adiabats", &nbLine, 1, 1, 10);
-        ImGui::DragFloat("Min temperature (°C)", &minTemp, 1, -40, 40);
-        ImGui::DragFloat("temperature Delta (°C)", &deltaTemp, 1, 0.5, 10);
-
-        ImGui::TreePop();
+        a_drawList->AddText(a_graphOrigin + label.position, colLabel,
+                            label.text.c_str());
     }
 }
 
@@ -313,6 +168,42 @@ void draw_reticule(ImVec2 const &a_position, ImColor const &a_color)
                       a_color, 1.0f);
 }
 
+void set_harnessWindowLayout(char const *a_name, ImVec2 const &a_position,
+                             ImVec2 const &a_size)
+{
+    ImGui::SetWindowPos(a_name, a_position, ImGuiCond_Always);
+    ImGui::SetWindowSize(a_name, a_size, ImGuiCond_Always);
+    ImGui::SetWindowCollapsed(a_name, false, ImGuiCond_Always);
+    if (ImGuiWindow *window = ImGui::FindWindowByName(a_name))
+    {
+        // Tree nodes state and scrolling
+        window->StateStorage.Clear();
+        ImGui::SetScrollY(window, 0.0f);
+    }
+}
+
+// Fixed layout of the frame time harness, imgui.ini is not used while
+// recording or replaying so the recorded input lands on the same widgets.
+// To call once all the windows of the frame are submitted.
+void apply_harnessLayout()
+{
+    const mFloat panelWidth = 320.0f;
+    const mFloat infoHeight = 160.0f;
+
+    ImGuiViewport const *viewport = ImGui::GetMainViewport();
+    ImVec2 const        &origin   = viewport->WorkPos;
+    ImVec2 const        &size     = viewport->WorkSize;
+
+    set_harnessWindowLayout("Tephigram Parameters", origin,
+                            {panelWidth, size.y - infoHeight});
+    set_harnessWindowLayout("Application info",
+                            origin + ImVec2(0.0f, size.y - infoHeight),
+                            {panelWidth, infoHeight});
+    set_harnessWindowLayout("Tephigram", origin + ImVec2(panelWidth, 0.0f),
+                            {size.x - panelWidth, size.y});
+    ImGui::ClearActiveID();
+}
+
 class TephigramApp : public m::crossPlatform::IWindowedApplication
 {
     void init(m::mCmdLine const &a_cmdLine, void *a_appData) override
@@ -388,11 +279,72 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
             m::input::mKeyActionCallback(
                 [] { mEnable_logChannels(m_Tephigram_ID); }));
 
-        set_minimalStepDuration(std::chrono::milliseconds(16));
+        // Frame time regression harness, TEPHIGRAM_RECORD=<file> records the
+        // session, TEPHIGRAM_REPLAY=<file>[;<file>...] replays recordings
+        // without frame limiter and exits
+        char const *replayPaths = std::getenv("TEPHIGRAM_REPLAY");
+        char const *recordPath  = std::getenv("TEPHIGRAM_RECORD");
+        if (replayPaths || recordPath)
+        {
+            // Windows are laid out by apply_harnessLayout
+            ImGuiIO &io    = ImGui::GetIO();
+            io.IniFilename = nullptr;
+            io.ConfigFlags &= ~ImGuiConfigFlags_DockingEnable;
+        }
+
+        if (replayPaths)
+        {
+            // A gating job must not fall back to an interactive session
+            if (!m_replayer.start(replayPaths))
+            {
+                std::cerr << "Failed to start replay of " << replayPaths
+                          << '\n';
+                std::exit(EXIT_FAILURE);
+            }
+            m_isReplaySession = true;
+        }
+        else if (recordPath)
+        {
+            m_recorder.start(recordPath);
+        }
+
+        // Local render server, TEPHIGRAM_SERVE=<port>, see RenderServer.hpp
+        if (char const *servePort = std::getenv("TEPHIGRAM_SERVE"))
+        {
+            std::string_view portText(servePort);
+            mUInt            port = 0;
+            auto [portEnd, portError] = std::from_chars(
+                portText.data(), portText.data() + portText.size(), port);
+            if (portError != std::errc() ||
+                portEnd != portText.data() + portText.size() || port == 0 ||
+                port > 65535)
+            {
+                std::cerr << "TEPHIGRAM_SERVE must be a port in [1, 65535], "
+                          << "got \"" << servePort << "\"\n";
+                std::exit(EXIT_FAILURE);
+            }
+
+            mUInt nbWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+            if (!m_renderServer.start(port, nbWorkers))
+            {
+                std::cerr << "Failed to start render server on port " << port
+                          << '\n';
+                std::exit(EXIT_FAILURE);
+            }
+            std::cout << "Render server listening on 127.0.0.1:" << port
+                      << std::endl;
+        }
+
+        set_minimalStepDuration(m_isReplaySession
+                                    ? std::chrono::milliseconds(0)
+                                    : std::chrono::milliseconds(16));
     }
 
     void destroy() override
     {
+        m_recorder.stop();
+        m_renderServer.stop();
+
         m::crossPlatform::IWindowedApplication::destroy();
 
         m_pDx12SynchTool->destroy();
@@ -407,6 +359,54 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
         m::dearImGui::destroy();
     }
 
+    // a_bins is empty when the soundings could not be loaded
+    void merge_climatology(DensityHistogram::Bins const &a_bins)
+    {
+        if (a_bins.empty())
+        {
+            std::cerr << "Failed to load soundings from " << m_cp.path << '\n';
+            return;
+        }
+        m_climatology.merge(a_bins);
+    }
+
+    // Soundings are loaded and binned in the background, the bins are merged
+    // in the climatology once ready. Replays load them synchronously, the
+    // frames of a scenario must not depend on the loading thread.
+    void update_climatology()
+    {
+        if (m_cp.clearRequested)
+        {
+            m_climatology.clear();
+        }
+
+        if (m_cp.loadRequested && m_isReplaySession)
+        {
+            merge_climatology(
+                DensityHistogram::load_bins(std::string(m_cp.path)));
+        }
+        else if (m_cp.loadRequested && !m_pendingClimatology.valid())
+        {
+            m_pendingClimatology =
+                std::async(std::launch::async, &DensityHistogram::load_bins,
+                           std::string(m_cp.path));
+        }
+
+        if (m_pendingClimatology.valid())
+        {
+            if (m_pendingClimatology.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready)
+            {
+                ImGui::Text("Loading soundings...");
+                return;
+            }
+
+            merge_climatology(m_pendingClimatology.get());
+        }
+
+        ImGui::Text("Climatology levels: %zu", m_climatology.get_nbLevels());
+    }
+
     m::mBool step(
         std::chrono::steady_clock::duration const &a_deltaTime) override
     {
@@ -415,6 +415,8 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
             return false;
         }
 
+        auto const frameStart = std::chrono::steady_clock::now();
+
         static mDouble currentTime = 0.0;
         currentTime +=
             0.001 *
@@ -425,7 +427,11 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
             currentTime -= 2.0 * std::numbers::pi;
         }
 
+        mBool const isSettingHarnessLayout =
+            m_recorder.is_settingLayout() || m_replayer.is_settingLayout();
+
         start_dearImGuiNewFrame(*m_pDx12Api);
+        m_replayer.feed_input(ImGui::GetIO());
 
         ImGui::NewFrame();
 
@@ -451,24 +457,42 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
 
         ImGui::End();
 
+        if (m_renderServer.is_running())
+        {
+            RenderServerMetrics metrics = m_renderServer.get_metrics();
+            ImGui::Begin("Render server");
+            ImGui::Text("Requests: %zu", metrics.nbRequests);
+            ImGui::Text("Cache hits: %zu", metrics.nbCacheHits);
+            ImGui::Text("Errors: %zu", metrics.nbErrors);
+            ImGui::Text("Throughput (req/s): %f", metrics.throughput);
+            ImGui::Text("Latency p50 (us): %f", metrics.latencyP50);
+            ImGui::Text("Latency p99 (us): %f", metrics.latencyP99);
+            ImGui::End();
+        }
+
         // Tephigram-----------
         ImGui::Begin("Tephigram Parameters");
 
-        m_gp.expose_dearImGui();
+        m_isoplethsDirty |= m_gp.expose_dearImGui();
+        m_isoplethsDirty |= m_plp.expose_dearImGui();
+        m_isoplethsDirty |= m_vlp.expose_dearImGui();
+        m_isoplethsDirty |= m_pap.expose_dearImGui();
+        m_cp.expose_dearImGui();
+        m_replayer.apply_climatology(m_cp);
+        update_climatology();
 
-        mFloat minTemp   = m_gp.boundTemp[0];
-        mFloat maxTemp   = m_gp.boundTemp[1];
-        mFloat deltaTemp = (maxTemp - minTemp) / (m_gp.divTemp + 1);
-        mFloat minPhi    = m_gp.boundPhi[0];
-        mFloat maxPhi    = m_gp.boundPhi[1];
-        mFloat deltaPhi  = (maxPhi - minPhi) / (m_gp.divPhi + 1);
-        mFloat angle     = std::numbers::pi * m_gp.rotation;
+        ImGui::End();
 
-        m_plp.expose_dearImGui();
-        m_vlp.expose_dearImGui();
-        m_pap.expose_dearImGui();
+        m_isoplethsDirty |=
+            m_replayer.apply_parameters(m_gp, m_plp, m_vlp, m_pap);
+        m_recorder.record_frame(ImGui::GetIO(), m_gp, m_plp, m_vlp, m_pap,
+                                m_cp);
 
-        ImGui::End();
+        mFloat minTemp = m_gp.boundTemp[0];
+        mFloat maxTemp = m_gp.boundTemp[1];
+        mFloat minPhi  = m_gp.boundPhi[0];
+        mFloat maxPhi  = m_gp.boundPhi[1];
+        mFloat angle   = std::numbers::pi * m_gp.rotation;
 
         ImGui::Begin("Tephigram");
         ImGuiContext &G        = *GImGui;
@@ -481,13 +505,10 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
         const ImVec2 sizeGraph   = canvasSize - sizePadding - sizePadding;
         const ImVec2 graphOrigin =
             position + ImVec2(sizePadding.x, sizePadding.y + sizeGraph.y);
-        const ImU32 colCanvas      = ImColor(0.95f, 0.95f, 0.85f, 1.0f);
-        const ImU32 colBg          = ImColor(0.9f, 0.9f, 0.8f, 1.0f);
-        const ImU32 colCursor      = ImColor(0.9f, 0.1f, 0.1f, 1.0f);
-        const ImU32 colLine        = ImColor(0.0f, 0.1f, 0.2f, 0.7f);
-        const ImU32 colPress       = ImColor(0.0f, 0.1f, 0.2f, 0.2f);
-        const ImU32 colVapor       = ImColor(0.0f, 0.6f, 0.2f, 0.2f);
-        const ImU32 colPseudoAdiab = ImColor(0.1f, 0.0f, 0.2f, 0.2f);
+        const ImU32 colCanvas = ImColor(get_chartColor(ChartElement::canvas));
+        const ImU32 colCursor = ImColor(0.9f, 0.1f, 0.1f, 1.0f);
+        const ImU32 colBg =
+            ImColor(get_chartColor(ChartElement::background));
 
         ImVec2 frameSize = ImGui::CalcItemSize(canvasSize, 400, 300);
 
@@ -495,59 +516,20 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
         drawList->AddRectFilled(position + sizePadding,
                                 position + sizePadding + sizeGraph, colBg);
 
-        mFloat yPosNutre = 0;
-        mFloat xPosNutre = 0;
-
         // Clip rect
         ImGui::PushClipRect(position + sizePadding,
                             position + sizePadding + sizeGraph, true);
 
-        mFloat tiltX             = std::tan(angle) * (0.5 * sizeGraph.y);
-        mFloat sizeHorizontal    = sizeGraph.x / (m_gp.divTemp + 1);
-        mInt   additionalDivTemp = tiltX / sizeHorizontal;
-
-        mFloat tiltY            = std::tan(angle) * (0.5 * sizeGraph.x);
-        mFloat sizeVertical     = sizeGraph.y / (m_gp.divPhi + 1);
-        mInt   additionalDivPhi = tiltY / sizeVertical;
-
-        // Crooked
-        for (mInt i = -additionalDivTemp;
-             i <= (m_gp.divTemp + additionalDivTemp); ++i)
+        if (m_cp.showDensity)
         {
-
-            mFloat xPos = i * sizeHorizontal;
-            mFloat tilt = std::tan(angle) * (0.5 * sizeGraph.y);
-
-            drawList->AddLine(graphOrigin + ImVec2(xPos - tilt, yPosNutre),
-                              graphOrigin + ImVec2(xPos + tilt, -sizeGraph.y),
-                              colLine);
-
-            mFloat temperature = minTemp + deltaTemp * i;
-
-            char string[16];
-            ImFormatString(string, 16, "%.0f", temperature);
-            drawList->AddText(graphOrigin + ImVec2(xPos, -(0.5 * sizeGraph.y)),
-                              colLine, string);
+            update_densityHeatmap(m_heatmap, m_climatology, sizeGraph, angle,
+                                  m_gp, m_cp.opacity);
+            draw_densityHeatmap(drawList, m_heatmap, graphOrigin);
         }
 
-        for (mInt i = -additionalDivPhi; i <= (m_gp.divPhi + additionalDivPhi);
-             ++i)
-        {
-            mFloat yPos = -sizeVertical * i;
-            mFloat tilt = std::tan(angle) * (0.5 * sizeGraph.x);
-
-            drawList->AddLine(graphOrigin + ImVec2(xPosNutre, yPos - tilt),
-                              graphOrigin + ImVec2(sizeGraph.x, yPos + tilt),
-                              colLine);
-
-            mFloat phi = minPhi + deltaPhi * i;
-
-            char string[16];
-            ImFormatString(string, 16, "%.0f", phi);
-            drawList->AddText(
-                graphOrigin + ImVec2((0.5 * sizeGraph.x) + 5, yPos - 5),
-                colLine, string);
-        }
+        build_chartGeometry(m_geometry, m_isopleths, m_isoplethsDirty, m_gp,
+                            m_plp, m_vlp, m_pap, sizeGraph);
+        draw_chartGeometry(drawList, m_geometry, graphOrigin);
 
         // Cursor data
         mousePos = ImVec2(ImGui::GetMousePos().x - graphOrigin.x,
@@ -566,148 +548,34 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
         ImVec2 drawMousePos = ImGui::GetMousePos();
         draw_reticule(drawMousePos, colCursor);
 
-        // Pressure Lines
-        if (m_plp.showPressureLine)
-        {
-            std::vector<std::vector<ImVec2>> lines;
-            lines.resize(m_plp.nbPressureLine);
-            for (auto &line : lines)
-            {
-                line.resize(m_gp.divTemp + 2 * additionalDivTemp + 2);
-            }
-            for (mInt i = -additionalDivTemp;
-                 i <= (m_gp.divTemp + additionalDivTemp) + 1; ++i)
-            {
-                mFloat temperature = minTemp + deltaTemp * i;
-                for (mUInt k = 0; k < m_plp.nbPressureLine; ++k)
-                {
-                    mFloat pressure =
-                        m_plp.maxPressure - k * m_plp.deltaPressure;
-                    mDouble tephi = get_phi(temperature, pressure);
-                    ImVec2  pos   = get_posFromTempAndPhi(
-                           temperature, tephi, m_gp.boundTemp, m_gp.boundPhi,
-                           sizeGraph, angle);
-                    lines[k][i + additionalDivTemp] = graphOrigin + pos;
-                }
-            }
+        ImGui::PopClipRect();
 
-            for (mUInt k = 0; k < m_plp.nbPressureLine; ++k)
-            {
-                mFloat pressure = m_plp.maxPressure - k * m_plp.deltaPressure;
-                mFloat x        = (m_gp.divTemp / 4) * sizeHorizontal;
-                mFloat y =
-                    get_yFromXandPressure(x, pressure, {minTemp, maxTemp},
-                                          {minPhi, maxPhi}, sizeGraph, angle);
-                {
-                    char string[16];
-                    ImFormatString(string, 16, "p:%d", mInt(pressure));
-                    drawList->AddText(
-                        ImVec2(graphOrigin.x + x, graphOrigin.y - y), colLine,
-                        string);
-                }
-            }
+        ImGui::End();
 
-            for (auto &line : lines)
-            {
-                drawList->AddPolyline(line.data(), line.size(), colPress, 0,
-                                      1.0f);
-            }
+        if (isSettingHarnessLayout)
+        {
+            apply_harnessLayout();
         }
 
-        // Vapor Lines
-        if (m_vlp.showVaporLines)
-        {
-            // Vapor lines
-            std::vector<std::vector<ImVec2>> vaporLines;
-            vaporLines.resize(m_vlp.nbVaporLines);
-            for (auto &line : vaporLines)
-            {
-                line.resize(m_gp.divTemp + 2 * additionalDivTemp + 2);
-            }
-            for (mInt i = -additionalDivTemp;
-                 i <= (m_gp.divTemp + additionalDivTemp) + 1; ++i)
-            {
-                mFloat temperature = minTemp + deltaTemp * i;
-                for (mUInt k = 0; k < m_vlp.nbVaporLines; ++k)
-                {
-                    mFloat ws = m_vlp.wss[k];
-
-                    mFloat pressure =
-                        get_pressureFromWandTemperature(ws, temperature);
-                    mDouble tephi = get_phi(temperature, pressure);
-                    ImVec2  pos   = get_posFromTempAndPhi(
-                           temperature, tephi, m_gp.boundTemp, m_gp.boundPhi,
-                           sizeGraph, angle);
-                    vaporLines[k][i + additionalDivTemp] = graphOrigin + pos;
-                }
-            }
+        // Render-----------
+        ImGui::Render();
 
-            for (auto &line : vaporLines)
-            {
-                drawList->AddPolyline(line.data(), line.size(), colVapor, 0,
-                                      1.0f);
-            }
-        }
+        // Measured before the taskset runs, its swapchain present may wait for
+        // vsync and would snap the frame times to the refresh interval
+        auto const frameTime = std::chrono::steady_clock::now() - frameStart;
 
-        // Pseudo Adiabats
-        if (m_pap.showPseudoAdiabats)
-        {
-            std::vector<std::vector<ImVec2>> lines;
-            lines.resize(m_pap.nbLine);
-            const mInt subDivisions  = 100;
-            const mInt pressureStart = 100;
-            const mInt pressureGoal  = 10;
-            mFloat deltaP = mFloat(pressureGoal - pressureStart) / subDivisions;
-            for (auto &line : lines) { line.resize(subDivisions); }
-
-            for (mUInt k = 0; k < m_pap.nbLine; ++k)
-            {
-                mFloat temperature = m_pap.minTemp + m_pap.deltaTemp * k;
-                mFloat pressure    = 100;
-                for (mInt d = 0; d < subDivisions; ++d)
-                {
-                    mDouble tephi = get_phi(temperature, pressure);
-                    ImVec2  pos   = get_posFromTempAndPhi(
-                           temperature, tephi, m_gp.boundTemp, m_gp.boundPhi,
-                           sizeGraph, angle);
-                    lines[k][d] = graphOrigin + pos;
-
-                    // Update temperature and pressure
-                    mFloat tempK   = g_c2k + temperature;
-                    mFloat L       = 2500000.0f;
-                    mFloat eaexpbt = g_eps * g_A * std::exp(-g_B / tempK);
-                    mFloat deltaT =
-                        deltaP *
-                        (g_k / pressure +
-                         eaexpbt * L / (tempK * pressure * pressure * g_cp)) /
-                        (1 / tempK +
-                         eaexpbt * g_B * L /
-                             (tempK * tempK * tempK * pressure * g_cp));
-
-                    temperature += deltaT;
-                    pressure += deltaP;
-                }
-            }
+        m_tasksetExecutor.run();
 
-            for (auto &line : lines)
+        if (m_isReplaySession)
+        {
+            m_replayer.end_frame(frameTime);
+            if (m_replayer.has_failed())
             {
-                for (mUInt i = 0; i < line.size() - 1; i += 2)
-                {
-                    drawList->AddLine(line[i], line[i + 1], colPseudoAdiab,
-                                      1.0f);
-                }
+                std::exit(EXIT_FAILURE);
             }
+            return m_replayer.is_replaying();
         }
 
-        ImGui::PopClipRect();
-
-        ImGui::End();
-
-        // Render-----------
-        ImGui::Render();
-
-        m_tasksetExecutor.run();
-
         return true;
     }
 
@@ -724,6 +592,21 @@ class TephigramApp : public m::crossPlatform::IWindowedApplication
     PressureLineParameters   m_plp;
     VaporLineParameters      m_vlp;
     PseudoAdiabatsParameters m_pap;
+
+    ChartIsopleths m_isopleths;
+    mBool          m_isoplethsDirty{true};
+    ChartGeometry  m_geometry;
+
+    InputRecorder m_recorder;
+    InputReplayer m_replayer;
+    mBool         m_isReplaySession{false};
+
+    RenderServer m_renderServer;
+
+    ClimatologyParameters               m_cp;
+    DensityHistogram                    m_climatology;
+    DensityHeatmap                      m_heatmap;
+    std::future<DensityHistogram::Bins> m_pendingClimatology;
 };
 
 M_EXECUTE_WINDOWED_APP(TephigramApp)